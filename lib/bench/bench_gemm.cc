@@ -0,0 +1,93 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+#include "linmath/contiguous_matrix.hpp"
+#include "linmath/simd_kernels.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace linmath = throttle::linmath;
+namespace kernels = linmath::kernels;
+
+namespace {
+
+template <typename F> double measure_ms(F func, unsigned repeat) {
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < repeat; ++i) {
+    func();
+  }
+  const auto finish = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(finish - start).count() / repeat;
+}
+
+linmath::contiguous_matrix_d random_matrix(std::size_t n) {
+  std::mt19937                           gen{42};
+  std::uniform_real_distribution<double> dist{-1, 1};
+  linmath::contiguous_matrix_d           res{n, n};
+  std::generate(res.begin(), res.end(), [&] { return dist(gen); });
+  return res;
+}
+
+// The product as it was done before the packed kernel: transpose a copy of B, one inner product per element.
+linmath::contiguous_matrix_d reference_product(const linmath::contiguous_matrix_d &a,
+                                               const linmath::contiguous_matrix_d &b) {
+  linmath::contiguous_matrix_d res{a.rows(), b.cols()};
+  const auto                   t_b = transpose(b);
+  for (std::size_t i = 0; i < a.rows(); ++i) {
+    for (std::size_t j = 0; j < t_b.rows(); ++j) {
+      res[i][j] = std::inner_product(a[i].begin(), a[i].end(), t_b[j].begin(), 0.0);
+    }
+  }
+  return res;
+}
+
+} // namespace
+
+// Usage: bench_gemm [size] [threads]. Prints GFLOP/s of the old inner product loop and of the packed kernel at every
+// SIMD level this CPU supports, single threaded and on a pool.
+int main(int argc, char *argv[]) {
+  const std::size_t n = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024);
+  const unsigned    threads = (argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::thread::hardware_concurrency());
+
+  const auto a = random_matrix(n), b = random_matrix(n);
+  const auto gflops = [n](double ms) { return 2.0 * n * n * n / ms / 1e6; };
+  const auto repeat = static_cast<unsigned>(std::max<std::size_t>(1, 512 * 512 * 512 / (n * n * n)));
+
+  std::cout << "n = " << n << ", threads = " << threads << "\n";
+  std::cout << std::setw(16) << "kernel" << std::setw(12) << "1 thread" << std::setw(12) << "pool\n";
+  std::cout << std::setw(16) << "inner_product" << std::setw(12)
+            << gflops(measure_ms([&] { static_cast<void>(reference_product(a, b)); }, repeat)) << "\n";
+
+  throttle::concurrency::thread_pool pool{threads};
+  for (auto level : {kernels::simd_level::scalar, kernels::simd_level::sse2, kernels::simd_level::avx2,
+                     kernels::simd_level::avx512}) {
+    if (level > kernels::detect_simd_level()) break;
+    kernels::set_simd_level(level);
+
+    const auto single = measure_ms([&] { static_cast<void>(a * b); }, repeat);
+    const auto parallel = measure_ms(
+        [&] {
+          auto c = a;
+          c.multiply(b, pool);
+        },
+        repeat);
+
+    std::cout << std::setw(16) << kernels::simd_level_name(level) << std::setw(12) << gflops(single) << std::setw(12)
+              << gflops(parallel) << "\n";
+  }
+}
@@ -0,0 +1,79 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+#include "linmath/matrix.hpp"
+#include "linmath/simd_kernels.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace linmath = throttle::linmath;
+namespace kernels = linmath::kernels;
+
+namespace {
+
+template <typename F> double measure_ms(F func, unsigned repeat) {
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < repeat; ++i) {
+    func();
+  }
+  const auto finish = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(finish - start).count() / repeat;
+}
+
+linmath::matrix_d random_matrix(std::size_t n) {
+  std::mt19937                           gen{42};
+  std::uniform_real_distribution<double> dist{-1, 1};
+  linmath::matrix_d                      res{n, n};
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      res[i][j] = dist(gen) + (i == j ? n : 0);
+    }
+  }
+  return res;
+}
+
+} // namespace
+
+// Usage: bench_kernels [size]. Prints the time per operation for every code path this CPU supports.
+int main(int argc, char *argv[]) {
+  const std::size_t n = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 512);
+  const auto        mat = random_matrix(n);
+
+  std::cout << "n = " << n << ", detected: " << kernels::simd_level_name(kernels::detect_simd_level()) << "\n";
+  std::cout << std::setw(10) << "level" << std::setw(16) << "row_echelon,ms" << std::setw(14) << "add+=,ms"
+            << std::setw(14) << "equal,ms" << std::setw(14) << "lu,ms\n";
+
+  for (auto level : {kernels::simd_level::scalar, kernels::simd_level::sse2, kernels::simd_level::avx2,
+                     kernels::simd_level::avx512}) {
+    if (level > kernels::detect_simd_level()) break;
+    kernels::set_simd_level(level);
+
+    const auto echelon = measure_ms(
+        [&mat] {
+          auto copy = mat;
+          copy.convert_to_row_echelon();
+        },
+        3);
+
+    auto       sum = mat;
+    const auto add = measure_ms([&] { sum += mat; }, 50);
+    const auto copy = mat;
+    const auto equal = measure_ms([&] { static_cast<void>(mat.equal(copy)); }, 50);
+    const auto lu = measure_ms([&] { static_cast<void>(linmath::lu_factorization<double>{mat}.determinant()); }, 3);
+
+    std::cout << std::setw(10) << kernels::simd_level_name(level) << std::setw(16) << echelon << std::setw(14) << add
+              << std::setw(14) << equal << std::setw(14) << lu << "\n";
+  }
+}
@@ -0,0 +1,94 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+#include "circuits/resistor_network.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace circuits = throttle::circuits;
+namespace linmath = throttle::linmath;
+
+using network_type = circuits::resistor_network<unsigned>;
+
+namespace {
+
+template <typename F> double measure_ms(F func) {
+  const auto start = std::chrono::steady_clock::now();
+  func();
+  const auto finish = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+// A side^dims mesh of random resistors with a single battery between two opposite corners.
+network_type make_mesh(unsigned side, unsigned dims) {
+  std::mt19937                           gen{42};
+  std::uniform_real_distribution<double> dist{0.5, 2.0};
+  network_type                           network;
+
+  unsigned nodes = 1;
+  for (unsigned d = 0; d < dims; ++d) {
+    nodes *= side;
+  }
+
+  for (unsigned v = 0; v < nodes; ++v) {
+    for (unsigned d = 0, stride = 1; d < dims; ++d, stride *= side) {
+      if ((v / stride) % side + 1 < side) network.insert(v, v + stride, dist(gen), 0.0);
+    }
+  }
+
+  network.insert(nodes - 1, 0, 1.0, 10.0);
+  return network;
+}
+
+} // namespace
+
+// Usage: bench_multigrid [max_side_2d] [max_side_3d]. Prints the full solve time of every method, the dense one only
+// while it stays reasonable.
+int main(int argc, char *argv[]) {
+  const unsigned max_2d = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256);
+  const unsigned max_3d = (argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 32);
+
+  const auto cg = circuits::solver_options{.method = circuits::solver_method::conjugate_gradient};
+  auto       amg = cg;
+  amg.cg.preconditioner = linmath::preconditioner_kind::algebraic_multigrid;
+
+  std::cout << std::setw(10) << "mesh" << std::setw(10) << "nodes" << std::setw(12) << "dense,ms" << std::setw(12)
+            << "lu,ms" << std::setw(12) << "ic-cg,ms" << std::setw(12) << "amg-cg,ms\n";
+
+  const auto run = [&](unsigned side, unsigned dims) {
+    const auto network = make_mesh(side, dims);
+    const auto nodes = static_cast<unsigned>(std::pow(side, dims));
+
+    std::cout << std::setw(8) << side << "^" << dims << std::setw(10) << nodes;
+    if (nodes <= 1500) {
+      std::cout << std::setw(12) << measure_ms([&] { network.solve({.method = circuits::solver_method::dense}); });
+    } else {
+      std::cout << std::setw(12) << "-";
+    }
+
+    std::cout << std::setw(12) << measure_ms([&] { network.solve(); });
+    std::cout << std::setw(12) << measure_ms([&] { network.solve(cg); });
+    std::cout << std::setw(12) << measure_ms([&] { network.solve(amg); }) << "\n";
+  };
+
+  for (unsigned side = 16; side <= max_2d; side *= 2) {
+    run(side, 2);
+  }
+
+  for (unsigned side = 8; side <= max_3d; side *= 2) {
+    run(side, 3);
+  }
+}
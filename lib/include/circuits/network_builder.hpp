@@ -0,0 +1,97 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Collects a network edge by edge, the way a parser produces it, for a single solve.
+ * Vertex identifiers are interned into 0, 1, ... as they arrive, with one hash lookup per end, and edges are kept in a
+ * flat array of indices. Unlike resistor_network there's no graph of hash maps to keep up to date and nothing is
+ * renumbered when solving, so a netlist goes from the parser to the solver with no other copy in between.
+ */
+
+#pragma once
+
+#include "circuits/resistor_network.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace throttle::circuits {
+
+template <typename T> class network_builder {
+public:
+  using size_type = std::size_t;
+  using edge_id = std::size_t;
+  using edge_type = typename resistor_network<T>::indexed_edge;
+
+private:
+  std::vector<T>                   m_labels;
+  std::unordered_map<T, size_type> m_index;
+  std::vector<edge_type>           m_edges;
+
+public:
+  network_builder() = default;
+
+  // Vertices numbered in advance, a binary netlist brings its own numbering for instance. Edges can then be inserted
+  // by index.
+  explicit network_builder(std::vector<T> labels) : m_labels(std::move(labels)) {
+    m_index.reserve(m_labels.size());
+    for (size_type i = 0; i < m_labels.size(); ++i) {
+      if (!m_index.try_emplace(m_labels[i], i).second) throw std::invalid_argument{"Duplicate vertex label"};
+    }
+  }
+
+  void reserve(size_type edges) { m_edges.reserve(edges); }
+
+  // Index of the vertex, which is added if it's new.
+  size_type intern(const T &id) {
+    const auto [found, inserted] = m_index.try_emplace(id, m_labels.size());
+    if (inserted) m_labels.push_back(id);
+    return found->second;
+  }
+
+  // Same meaning as resistor_network::insert(), the ids follow the order of insertion.
+  edge_id insert(const T &first, const T &second, double resistance = 0, double emf = 0) {
+    const auto i = intern(first);
+    return insert_indexed(i, intern(second), resistance, emf);
+  }
+
+  edge_id insert_indexed(size_type first, size_type second, double resistance = 0, double emf = 0) {
+    if (first >= vertices() || second >= vertices()) throw std::out_of_range{"Vertex index out of range"};
+    m_edges.push_back({first, second, resistance, emf});
+    return m_edges.size() - 1;
+  }
+
+  size_type vertices() const { return m_labels.size(); }
+  size_type edges() const { return m_edges.size(); }
+
+  const T                      &label(size_type i) const { return m_labels[i]; }
+  const std::vector<T>         &labels() const { return m_labels; }
+  const edge_type              &edge(edge_id e) const { return m_edges[e]; }
+  const std::vector<edge_type> &edge_list() const { return m_edges; }
+
+  indexed_solution<T> solve_indexed(const solver_options &opts = {}) const & {
+    return resistor_network<T>::solve_indexed(m_labels, m_index, m_edges, opts);
+  }
+
+  // For the last solve the labels and the index move into the solution instead of being copied. The edges stay, but
+  // the vertices are gone from the builder afterwards, so labels are looked up in the solution.
+  indexed_solution<T> solve_indexed(const solver_options &opts = {}) && {
+    return resistor_network<T>::solve_indexed(std::move(m_labels), std::move(m_index), m_edges, opts);
+  }
+
+  std::vector<double> solve_edges(const solver_options &opts = {}) const & { return solve_indexed(opts).currents(); }
+  std::vector<double> solve_edges(const solver_options &opts = {}) && {
+    return std::move(*this).solve_indexed(opts).currents();
+  }
+};
+
+} // namespace throttle::circuits
@@ -0,0 +1,319 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Series/parallel reduction of a connected resistor network.
+ * Every branch is a Thevenin source: a resistance R in series with an EMF E, so the current from the first to the
+ * second vertex is (phi_first - phi_second + E) / R, or a short circuit (R = 0) that fixes phi_first - phi_second = -E.
+ * Three local rules shrink the network without changing the currents anywhere:
+ *
+ * 1. A vertex of degree one carries no current. It's dropped and its potential is phi_neighbour + E.
+ * 2. A vertex of degree two is a series connection. Its branches merge into one with R = R1 + R2, E = E1 + E2.
+ * 3. Two branches between the same vertices are parallel. They merge into one with G = G1 + G2, E = (E1 G1 + E2 G2) / G,
+ *    or into the short circuit, if one of them is a short circuit. Two short circuits in parallel make the currents
+ *    undefined.
+ *
+ * Each rule is recorded, and after the reduced network is solved the steps are undone in reverse order to recover the
+ * potential of every removed vertex and the current in every original branch. Every rule is O(1) and can only enable
+ * rules on the neighbours, so the whole reduction runs in O(V + E). The ground vertex is never removed, which keeps the
+ * potentials of the reduced and of the original network on the same reference.
+ */
+
+#pragma once
+
+#include "datastructures/csr_graph.hpp"
+#include "equal.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace throttle::circuits::detail {
+
+template <typename T> class network_reduction {
+public:
+  using size_type = std::size_t;
+  using graph_type = containers::csr_graph<T, std::pair<double, double>>;
+  using solution_potentials = std::unordered_map<T, double>;
+  using solution_currents = std::unordered_map<T, std::unordered_map<T, double>>;
+
+  struct branch {
+    size_type first, second;
+    double    res, emf; // EMF from the first to the second vertex
+  };
+
+private:
+  enum class step_kind { dangling, series, parallel };
+
+  // dangling: branch a is removed together with vertex.
+  // series:   branches a and b through vertex are replaced by result.
+  // parallel: branches a and b are replaced by result.
+  struct step {
+    step_kind kind;
+    size_type result, a, b, vertex;
+  };
+
+  std::vector<T>                                        m_labels;
+  std::vector<branch>                                   m_branches;
+  std::vector<std::unordered_map<size_type, size_type>> m_adjacent; // Neighbour -> branch
+  std::vector<bool>                                     m_removed;
+  std::vector<step>                                     m_steps;
+  size_type                                             m_original_branches = 0, m_ground = 0;
+
+  static bool is_short(const branch &b) { return throttle::is_roughly_equal(b.res, 0.0); }
+
+  double sign(size_type e, size_type from) const { return (m_branches[e].first == from ? 1.0 : -1.0); }
+  double emf_from(size_type e, size_type from) const { return sign(e, from) * m_branches[e].emf; }
+
+  size_type other(size_type e, size_type from) const {
+    return (m_branches[e].first == from ? m_branches[e].second : m_branches[e].first);
+  }
+
+  size_type add_branch(size_type first, size_type second, double res, double emf) {
+    m_branches.push_back({first, second, res, emf});
+    return m_branches.size() - 1;
+  }
+
+  // Attach branch e between its vertices, merging it with a branch that's already there. Returns false for two
+  // short circuits in parallel.
+  bool connect(size_type e) {
+    const auto p = m_branches[e].first, q = m_branches[e].second;
+    auto       found = m_adjacent[p].find(q);
+
+    if (found == m_adjacent[p].end()) {
+      m_adjacent[p][q] = m_adjacent[q][p] = e;
+      return true;
+    }
+
+    const auto existing = found->second;
+    const auto a = m_branches[existing], b = m_branches[e];
+    size_type  merged;
+
+    if (is_short(a) && is_short(b)) return false;
+
+    if (is_short(a)) {
+      merged = add_branch(p, q, 0.0, emf_from(existing, p));
+    } else if (is_short(b)) {
+      merged = add_branch(p, q, 0.0, b.emf);
+    } else {
+      const auto ga = 1.0 / a.res, gb = 1.0 / b.res, g = ga + gb;
+      merged = add_branch(p, q, 1.0 / g, (emf_from(existing, p) * ga + b.emf * gb) / g);
+    }
+
+    m_steps.push_back({step_kind::parallel, merged, existing, e, 0});
+    m_adjacent[p][q] = m_adjacent[q][p] = merged;
+    return true;
+  }
+
+public:
+  // The graph is a simple one, every edge is taken once from its end with the smaller index.
+  network_reduction(const graph_type &graph, size_type ground) : m_labels(graph.labels()), m_ground{ground} {
+    for (size_type first = 0; first < graph.vertices(); ++first) {
+      const auto neighbours = graph.neighbours(first);
+      const auto attributes = graph.attributes(first);
+
+      for (size_type k = 0; k < neighbours.size(); ++k) {
+        if (first < neighbours[k]) add_branch(first, neighbours[k], attributes[k].first, attributes[k].second);
+      }
+    }
+
+    m_original_branches = m_branches.size();
+  }
+
+  // Vertices are given by their index into labels. Unlike the graph, the branches may contain parallel edges, which
+  // reduce() merges in any case. Self loops are not allowed.
+  network_reduction(std::vector<T> labels, std::vector<branch> branches, size_type ground)
+      : m_labels(std::move(labels)), m_branches(std::move(branches)), m_original_branches{m_branches.size()},
+        m_ground{ground} {}
+
+  // Apply the rules until none is applicable. With series = false only parallel branches are merged, which is the
+  // least it takes to get a simple graph. Returns false if the currents are undefined.
+  bool reduce(bool series = true) {
+    m_adjacent.assign(m_labels.size(), {});
+    m_removed.assign(m_labels.size(), false);
+
+    for (size_type e = 0; e < m_original_branches; ++e) {
+      if (!connect(e)) return false;
+    }
+
+    if (!series) return true;
+
+    std::vector<size_type> work(m_labels.size());
+    for (size_type i = 0; i < work.size(); ++i) {
+      work[i] = i;
+    }
+
+    while (!work.empty()) {
+      const auto x = work.back();
+      work.pop_back();
+
+      if (m_removed[x] || x == m_ground) continue;
+      auto &adjacent = m_adjacent[x];
+
+      if (adjacent.size() == 1) {
+        const auto [p, e] = *adjacent.begin();
+        m_adjacent[p].erase(x);
+        adjacent.clear();
+        m_removed[x] = true;
+        m_steps.push_back({step_kind::dangling, e, e, e, x});
+        work.push_back(p);
+      } else if (adjacent.size() == 2) {
+        const auto [p, a] = *adjacent.begin();
+        const auto [q, b] = *std::next(adjacent.begin());
+        m_adjacent[p].erase(x);
+        m_adjacent[q].erase(x);
+        adjacent.clear();
+        m_removed[x] = true;
+
+        const auto series = add_branch(p, q, m_branches[a].res + m_branches[b].res, emf_from(a, p) + emf_from(b, x));
+        m_steps.push_back({step_kind::series, series, a, b, x});
+        if (!connect(series)) return false;
+
+        work.push_back(p);
+        work.push_back(q);
+      }
+    }
+
+    return true;
+  }
+
+  size_type vertices() const { return std::count(m_removed.begin(), m_removed.end(), false); }
+
+private:
+  // Index of every remaining vertex in reduced_graph(), the ground first.
+  std::vector<size_type> reduced_index() const {
+    std::vector<size_type> index(m_labels.size(), static_cast<size_type>(-1));
+    size_type              next = 0;
+
+    index[m_ground] = next++;
+    for (size_type p = 0; p < m_labels.size(); ++p) {
+      if (!m_removed[p] && p != m_ground) index[p] = next++;
+    }
+
+    return index;
+  }
+
+  // Calls func(e) for every remaining branch, in the order of the edges of reduced_graph().
+  template <typename F> void for_each_remaining(F func) const {
+    for (size_type p = 0; p < m_labels.size(); ++p) {
+      for (const auto &[q, e] : m_adjacent[p]) {
+        if (p == m_branches[e].first) func(e);
+      }
+    }
+  }
+
+public:
+  // The network that remains, with the original vertex identifiers. The ground comes first, and a lone ground vertex
+  // is kept as an isolated one.
+  graph_type reduced_graph() const {
+    const auto     index = reduced_index();
+    std::vector<T> labels(vertices());
+
+    for (size_type p = 0; p < m_labels.size(); ++p) {
+      if (!m_removed[p]) labels[index[p]] = m_labels[p];
+    }
+
+    std::vector<typename graph_type::edge> edges;
+    for_each_remaining([&](size_type e) {
+      const auto &b = m_branches[e];
+      edges.push_back({index[b.first], index[b.second], {b.res, b.emf}, {b.res, -b.emf}});
+    });
+
+    return {std::move(labels), edges};
+  }
+
+  // Undo the reduction, given the solution of reduced_graph() by vertex index and by entry (see csr_graph). Returns the
+  // potential of every vertex and the current of every original branch from its first to its second vertex, both
+  // indexed like the input. Potentials are shifted to make the ground zero.
+  std::pair<std::vector<double>, std::vector<double>> expand_dense(const graph_type          &reduced,
+                                                                   const std::vector<double> &potentials,
+                                                                   const std::vector<double> &currents) const {
+    std::vector<double> phi(m_labels.size()), current(m_branches.size());
+    const auto          index = reduced_index();
+
+    for (size_type p = 0; p < m_labels.size(); ++p) {
+      if (!m_removed[p]) phi[p] = potentials[index[p]] - potentials[0];
+    }
+
+    for_each_remaining([&, j = size_type{0}](size_type e) mutable { current[e] = currents[reduced.edge_entry(j++)]; });
+
+    for (auto start = m_steps.rbegin(), finish = m_steps.rend(); start != finish; ++start) {
+      const auto &s = *start;
+
+      switch (s.kind) {
+      case step_kind::dangling: {
+        const auto p = other(s.a, s.vertex);
+        current[s.a] = 0.0;
+        phi[s.vertex] = phi[p] + emf_from(s.a, p);
+        break;
+      }
+
+      case step_kind::series: {
+        const auto p = m_branches[s.result].first;
+        current[s.a] = sign(s.a, p) * current[s.result];
+        current[s.b] = sign(s.b, s.vertex) * current[s.result];
+        phi[s.vertex] = phi[p] + emf_from(s.a, p) - current[s.result] * m_branches[s.a].res;
+        break;
+      }
+
+      case step_kind::parallel: {
+        const auto p = m_branches[s.result].first;
+        const auto voltage = phi[p] - phi[m_branches[s.result].second];
+        const auto through = [&](size_type e) { return (voltage + emf_from(e, p)) / m_branches[e].res; };
+
+        double a_current, b_current;
+        if (is_short(m_branches[s.a])) {
+          b_current = through(s.b);
+          a_current = current[s.result] - b_current;
+        } else if (is_short(m_branches[s.b])) {
+          a_current = through(s.a);
+          b_current = current[s.result] - a_current;
+        } else {
+          a_current = through(s.a);
+          b_current = through(s.b);
+        }
+
+        current[s.a] = sign(s.a, p) * a_current;
+        current[s.b] = sign(s.b, p) * b_current;
+        break;
+      }
+      }
+    }
+
+    current.resize(m_original_branches);
+    return {phi, current};
+  }
+
+  // Same as expand_dense(), keyed by vertex identifiers like the solution of a network.
+  std::pair<solution_potentials, solution_currents> expand(const graph_type          &reduced,
+                                                           const std::vector<double> &potentials,
+                                                           const std::vector<double> &currents) const {
+    const auto [phi, current] = expand_dense(reduced, potentials, currents);
+
+    solution_potentials result_potentials;
+    solution_currents   result_currents;
+
+    for (size_type p = 0; p < m_labels.size(); ++p) {
+      result_potentials[m_labels[p]] = phi[p];
+    }
+
+    for (size_type e = 0; e < m_original_branches; ++e) {
+      const auto &b = m_branches[e];
+      result_currents[m_labels[b.first]][m_labels[b.second]] = current[e];
+      result_currents[m_labels[b.second]][m_labels[b.first]] = -current[e];
+    }
+
+    return {result_potentials, result_currents};
+  }
+};
+
+} // namespace throttle::circuits::detail
@@ -8,17 +8,26 @@
  * ----------------------------------------------------------------------------
  */
 
-#include "datastructures/disjoint_set_forest.hpp"
+#include "circuits/network_reduction.hpp"
+#include "concurrency/task_graph.hpp"
+#include "concurrency/thread_pool.hpp"
+#include "datastructures/component_labelling.hpp"
+#include "datastructures/csr_graph.hpp"
+#include "datastructures/dense_disjoint_set_forest.hpp"
 #include "datastructures/ud_asymmetric_graph.hpp"
 #include "datastructures/vector.hpp"
 #include "equal.hpp"
+#include "linmath/conjugate_gradient.hpp"
 #include "linmath/contiguous_matrix.hpp"
 #include "linmath/linear_solver.hpp"
 #include "linmath/matrix.hpp"
 
 #include <algorithm>
 #include <exception>
+#include <functional>
 #include <iterator>
+#include <limits>
+#include <numeric>
 #include <optional>
 #include <stdexcept>
 #include <string>
@@ -35,6 +44,20 @@ namespace throttle::circuits {
 
 using resistance_emf_pair = std::pair<double, double>;
 
+// How the nodal system of each connected component is assembled and solved. The dense path materializes the full
+// (n x n+1) extended matrix and should only be requested for small circuits or for cross-checking. Short circuits are
+// contracted before assembly, so the matrix is always symmetric positive definite and conjugate gradient applies to any
+// circuit.
+enum class solver_method { dense, sparse, conjugate_gradient };
+
+// With reduce set, series and parallel connections and dangling vertices are collapsed before the system is assembled.
+struct solver_options {
+  solver_method                               method = solver_method::sparse;
+  linmath::conjugate_gradient_options<double> cg = {};
+  unsigned                                    threads = 1; // Zero means all hardware threads
+  bool                                        reduce = true;
+};
+
 class circuit_error : public std::exception {
   std::string m_message;
 
@@ -46,218 +69,735 @@ public:
 namespace detail {
 template <typename T> class connected_resistor_network {
 public:
-  struct short_circuit_edge {
-    T      first, second;
-    double emf;
-  };
-
   using circuit_graph_type = containers::ud_asymmetric_graph<T, resistance_emf_pair>;
+  using component_type = typename circuit_graph_type::component_view;
+  using csr_graph_type = containers::csr_graph<T, resistance_emf_pair>;
   using solution_potentials = std::unordered_map<T, double>;
   using solution_currents = std::unordered_map<T, std::unordered_map<T, double>>;
   using solution = std::pair<solution_potentials, solution_currents>;
 
+  // Potentials by vertex index and currents by entry of a csr_graph, from the vertex to its neighbour.
+  struct dense_solution {
+    std::vector<double> potentials, currents;
+  };
+
+  // EMFs that replace the ones the edges were inserted with. The key is an edge in the direction of the EMF, the
+  // reverse direction gets the opposite sign. Edges that aren't mentioned keep their original EMF.
+  using edge_key = std::pair<T, T>;
+  using emf_assignment = std::unordered_map<edge_key, double, boost::hash<edge_key>>;
+
 private:
-  circuit_graph_type              m_graph;
-  std::vector<short_circuit_edge> m_short_circuits;
+  component_type m_graph;
 
   struct connected_resistor_network_solver {
     using system_type = linmath::linear_equation_system<double>;
+    using sparse_system_type = linmath::sparse_linear_system<double>;
     using equation_type = typename system_type::equation_type;
-    using mapped_pair = std::pair<unsigned, unsigned>;
-
-    const connected_resistor_network &network;
-
-    std::unordered_map<T, unsigned> id_map;         // Maps identifier from input to 0, 1, ...
-    std::unordered_map<unsigned, T> inverse_id_map; // Maps 0, 1, ... to the input identifiers
-    std::unordered_map<mapped_pair, std::pair<unsigned, double>, boost::hash<mapped_pair>>
-        short_circuit_current_map; // Maps pairs of input indexes to current variable
-    const typename circuit_graph_type::size_type vertices, num_short_circuits;
-    unsigned                                     zero_potential_mapped_id;
-
-    connected_resistor_network_solver(const connected_resistor_network &circuit)
-        : network{circuit}, vertices{network.m_graph.vertices()}, num_short_circuits{network.m_short_circuits.size() /
-                                                                                     2} {
-      for (auto j = 0; const auto &v : network.m_graph) {
-        id_map[v.first] = j;
-        inverse_id_map[j++] = v.first;
-      }
 
-      for (auto j = vertices; const auto &v : network.m_short_circuits) {
-        const auto  mapped_first = id_map.at(v.second), mapped_second = id_map.at(v.first);
-        mapped_pair canonical_pair = {mapped_first < mapped_second ? mapped_pair{mapped_first, mapped_second}
-                                                                   : mapped_pair{mapped_second, mapped_first}};
-        if (short_circuit_current_map.contains(canonical_pair)) continue;
-        short_circuit_current_map.insert({canonical_pair, {j++, v.emf}});
+    // Returns the EMF of the edge first -> second, given the one stored in the graph.
+    using emf_lookup = std::function<double(const T &, const T &, double)>;
+
+    static constexpr unsigned no_parent = std::numeric_limits<unsigned>::max();
+
+    // Vertex 0 of the graph is the ground. Every pass below walks its flat arrays instead of hash maps.
+    const csr_graph_type &graph;
+    const unsigned        vertices;
+
+    static constexpr unsigned zero_potential_mapped_id = 0;
+
+    // Vertices joined by short circuits form a supernode with a single potential unknown. Within a supernode the
+    // short circuits are a spanning tree, listed in tree_order from the root down. The root of the ground supernode is
+    // the ground itself, and that supernode is number zero.
+    std::vector<unsigned>    supernode, tree_parent, tree_order;
+    std::vector<double>      tree_emf;   // Stored EMF of the short circuit from the parent
+    std::vector<std::size_t> tree_entry; // Entry of the short circuit from the parent
+    unsigned                 supernodes = 0;
+
+    struct short_link {
+      unsigned    next;
+      double      emf; // EMF towards next
+      std::size_t entry;
+    };
+
+    connected_resistor_network_solver(const csr_graph_type &circuit) : graph{circuit}, vertices(graph.vertices()) {
+      // Step 1. Contract short circuits. Closing a loop of them would leave the current around it undefined.
+      containers::dense_disjoint_set_forest dsu{vertices};
+      std::vector<std::vector<short_link>>  shorted(vertices);
+
+      for (unsigned first = 0; first < vertices; ++first) {
+        const auto neighbours = graph.neighbours(first);
+        const auto attributes = graph.attributes(first);
+
+        for (std::size_t k = 0; k < neighbours.size(); ++k) {
+          const auto second = neighbours[k];
+          const auto [res, emf] = attributes[k];
+          // Every short circuit is listed in both directions
+          if (first > second || !throttle::is_roughly_equal(res, 0.0)) continue;
+          if (!dsu.union_set(first, second))
+            throw circuit_error{"The circuit is undefined. Possible infinite current loop"};
+
+          const auto entry = graph.offset(first) + k;
+          shorted[first].push_back({static_cast<unsigned>(second), emf, entry});
+          shorted[second].push_back({first, -emf, graph.twin(entry)});
+        }
       }
 
-      zero_potential_mapped_id = id_map.at(network.m_graph.begin()->first);
+      // Step 2. Number the supernodes and orient their trees with a breadth first walk, starting from the ground.
+      supernode.assign(vertices, no_parent);
+      tree_parent.assign(vertices, no_parent);
+      tree_emf.assign(vertices, 0.0);
+      tree_entry.assign(vertices, 0);
+      tree_order.reserve(vertices);
+
+      const auto walk = [this, &shorted](unsigned root) {
+        supernode[root] = supernodes;
+        tree_order.push_back(root);
+
+        for (auto k = tree_order.size() - 1; k < tree_order.size(); ++k) {
+          const auto current = tree_order[k];
+          for (const auto &[next, emf, entry] : shorted[current]) {
+            if (supernode[next] != no_parent) continue;
+            supernode[next] = supernodes;
+            tree_parent[next] = current;
+            tree_emf[next] = emf;
+            tree_entry[next] = entry;
+            tree_order.push_back(next);
+          }
+        }
+
+        ++supernodes;
+      };
+
+      walk(zero_potential_mapped_id);
+      for (unsigned i = 0; i < vertices; ++i) {
+        if (supernode[i] == no_parent) walk(i);
+      }
     }
 
-    auto make_system() const {
-      const auto variables = vertices + num_short_circuits;
-
-      // This is the linear system that we are constructing.
-      system_type   system;
-      equation_type equation(variables);
-      equation[zero_potential_mapped_id] = 1.0;
-      system.push(equation);
-      equation.reset();
-
-      // Step 1. Iterate over all points and use vertex current method to construct a linear equation.
-      for (auto start = std::next(network.m_graph.begin()), finish = network.m_graph.end(); start != finish; ++start) {
-        const auto &v = *start;
-
-        const auto &[current_id, adj_map] = v;
-        const auto current_mapped_id = id_map.at(current_id);
-
-        // Step 2. Find all vertices that are adjacent to the current one.
-        for (const auto &a : adj_map) {
-          const auto [res, emf] = a.second;
-          const auto second_id = a.first;
-          const auto second_mapped_id = id_map.at(second_id);
-          const bool is_second_zero_potential = (second_mapped_id == zero_potential_mapped_id);
-
-          if (throttle::is_roughly_equal(res, 0.0)) {
-            const bool first_less_second = current_mapped_id < second_mapped_id;
-            const auto current_var = (short_circuit_current_map.at(
-                                          (first_less_second) ? std::make_pair(current_mapped_id, second_mapped_id)
-                                                              : std::make_pair(second_mapped_id, current_mapped_id)))
-                                         .first;
-            equation[current_var] += (first_less_second ? 1.0 : -1.0);
-            continue;
-          }
+    // Potential of every vertex relative to the root of its supernode: a short circuit first -> second fixes
+    // phi_second = phi_first + emf.
+    std::vector<double> make_offsets(const emf_lookup &emf_of) const {
+      std::vector<double> offsets(vertices);
 
-          const auto conductivity = 1.0 / res;
+      for (const auto v : tree_order) {
+        const auto parent = tree_parent[v];
+        if (parent == no_parent) continue;
+        offsets[v] = offsets[parent] + emf_of(graph.label(parent), graph.label(v), tree_emf[v]);
+      }
 
-          equation[current_mapped_id] += conductivity;
-          if (!is_second_zero_potential) {
-            equation[second_mapped_id] -= conductivity;
-          }
+      return offsets;
+    }
 
-          equation.free_coeff() -= emf / res;
+    // Calls func(first, second, res, emf) for every resistive edge in both directions, with mapped vertices.
+    template <typename F> void for_each_resistor(F func) const {
+      for (unsigned first = 0; first < vertices; ++first) {
+        const auto neighbours = graph.neighbours(first);
+        const auto attributes = graph.attributes(first);
+
+        for (std::size_t k = 0; k < neighbours.size(); ++k) {
+          const auto [res, emf] = attributes[k];
+          if (throttle::is_roughly_equal(res, 0.0)) continue;
+          func(first, static_cast<unsigned>(neighbours[k]), res, emf);
         }
+      }
+    }
 
-        system.push(equation);
-        equation.reset();
+    // The nodal system over supernodes. Row s is the sum of the KCL equations of the vertices in supernode s, in which
+    // the short circuit currents cancel out. The ground supernode gets phi = 0 instead. Resistors inside a supernode
+    // only move current around in it and don't appear at all. The matrix is a grounded weighted Laplacian, so it's
+    // symmetric positive definite.
+    auto make_system() const {
+      std::vector<equation_type> equations(supernodes, equation_type(supernodes));
+      equations[0][0] = 1.0;
+
+      const auto free_coeffs = make_free_coeffs(stored_emf());
+      for_each_resistor([&](unsigned first, unsigned second, double res, double) {
+        const auto row = supernode[first], col = supernode[second];
+        if (row == 0 || row == col) return;
+        equations[row][row] += 1.0 / res;
+        if (col != 0) equations[row][col] -= 1.0 / res;
+      });
+
+      for (unsigned i = 0; i < supernodes; ++i) {
+        equations[i].free_coeff() = free_coeffs[i];
       }
 
-      for (const auto &v : short_circuit_current_map) {
-        const auto [first_id, second_id] = v.first;
-        const auto emf = v.second.second;
-        if (first_id != zero_potential_mapped_id) equation[first_id] = 1.0;
-        if (second_id != zero_potential_mapped_id) equation[second_id] = -1.0;
+      return system_type{equations};
+    }
 
-        equation.free_coeff() = -emf;
-        system.push(equation);
-        equation.reset();
+    // Same equations as make_system(), but every coefficient is stamped straight into a sparse system. Build cost is
+    // O(V + E).
+    auto make_sparse_system() const {
+      sparse_system_type system{supernodes, 2 * graph.edges() + supernodes};
+      system.stamp(0, 0, 1.0);
+
+      for_each_resistor([&](unsigned first, unsigned second, double res, double) {
+        const auto row = supernode[first], col = supernode[second];
+        if (row == 0 || row == col) return;
+        system.stamp(row, row, 1.0 / res);
+        if (col != 0) system.stamp(row, col, -1.0 / res);
+      });
+
+      const auto free_coeffs = make_free_coeffs(stored_emf());
+      for (unsigned i = 0; i < supernodes; ++i) {
+        system.free_coeff(i) = free_coeffs[i];
       }
 
       return system;
     }
 
-    solution solve() const {
-      if (network.m_graph.empty()) return solution{}; // If the network is empty, then there's nothing to do
+    static emf_lookup stored_emf() {
+      return [](const T &, const T &, double emf) { return emf; };
+    }
 
-      // Solve the linear system of equations to find unkown potentials and currents.
-      auto system = make_system();
+    static emf_lookup assigned_emf(const emf_assignment &assignment) {
+      return [&assignment](const T &first, const T &second, double emf) {
+        if (auto found = assignment.find({first, second}); found != assignment.end()) return found->second;
+        if (auto found = assignment.find({second, first}); found != assignment.end()) return -found->second;
+        return emf;
+      };
+    }
 
-      auto res = system.solve();
-      if (!res) throw circuit_error{"The circuit is undefined. Possible infinite current loop"};
-      auto unknowns = system.solve().value();
+    // Right hand side of the nodal system. Only this part depends on the EMFs, so a batch of EMF sets shares the
+    // matrix and its factorization.
+    std::vector<double> make_free_coeffs(const emf_lookup &emf_of) const {
+      std::vector<double> free_coeffs(supernodes);
+      const auto          offsets = make_offsets(emf_of);
 
-      // Fill base node potential with zero.
-      auto result_potentials = solution_potentials{};
-      for (const auto &v : network.m_graph) {
-        const auto id = v.first;
-        const auto mapped = id_map.at(id);
-        result_potentials[id] = unknowns[mapped][0];
+      for_each_resistor([&](unsigned first, unsigned second, double res, double emf) {
+        const auto row = supernode[first];
+        if (row == 0 || row == supernode[second]) return;
+        const auto drop = offsets[first] - offsets[second] + emf_of(graph.label(first), graph.label(second), emf);
+        free_coeffs[row] -= drop / res;
+      });
+
+      return free_coeffs;
+    }
+
+    std::optional<std::vector<double>> solve_unknowns(const solver_options &opts) const {
+      const auto method = opts.method;
+
+      if (method == solver_method::conjugate_gradient) {
+        const auto                                 system = make_sparse_system();
+        linmath::conjugate_gradient_solver<double> cg{system.get_matrix(), opts.cg};
+
+        auto res = cg.solve(system.free_coeffs());
+        if (!res) throw circuit_error{"Conjugate gradient did not converge"};
+        return res;
       }
 
-      // Fill unkown currents that were found as a part of linear system of m_equations.
-      auto result_currents = solution_currents{};
+      if (method != solver_method::dense) return make_sparse_system().solve();
 
-      for (const auto &v : short_circuit_current_map) {
-        const auto fwd_current = unknowns[v.second.first][0];
-        const auto first_original_id = inverse_id_map.at(v.first.first);
-        const auto second_original_id = inverse_id_map.at(v.first.second);
-        result_currents[first_original_id][second_original_id] = fwd_current;
-        result_currents[second_original_id][first_original_id] = -fwd_current;
+      const auto system = make_system();
+
+      std::optional<linmath::matrix<double>> res;
+      if (opts.threads == 1) {
+        res = system.solve();
+      } else {
+        concurrency::thread_pool pool{opts.threads};
+        res = system.solve(pool);
       }
 
-      // Compute other currents from potentials, when there are no short-circuits.
-      for (const auto &v : network.m_graph) {
-        for (const auto &c : v.second) {
-          const auto first_id = v.first, second_id = c.first;
-          if (throttle::is_roughly_equal(c.second.first, 0.0)) continue;
-          const auto [res, emf] = c.second;
-          const auto fwd_current = (result_potentials[first_id] - result_potentials[second_id] + emf) / res;
-          result_currents[first_id][second_id] = fwd_current;
+      if (!res) return std::nullopt;
+
+      const auto         &column = res.value();
+      std::vector<double> unknowns(column.rows());
+      for (unsigned i = 0; i < column.rows(); ++i) {
+        unknowns[i] = column[i][0];
+      }
+
+      return unknowns;
+    }
+
+    dense_solution make_dense_solution(const std::vector<double> &unknowns, const emf_lookup &emf_of) const {
+      const auto     offsets = make_offsets(emf_of);
+      dense_solution result{std::vector<double>(vertices), std::vector<double>(graph.entries())};
+      auto          &potentials = result.potentials;
+
+      for (unsigned i = 0; i < vertices; ++i) {
+        potentials[i] = unknowns[supernode[i]] + offsets[i];
+      }
+
+      // Currents through resistors follow from the potentials. leaving[v] accumulates the current that flows out of v
+      // through resistors.
+      std::vector<double> leaving(vertices);
+
+      for (unsigned first = 0; first < vertices; ++first) {
+        const auto neighbours = graph.neighbours(first);
+        const auto attributes = graph.attributes(first);
+
+        for (std::size_t k = 0; k < neighbours.size(); ++k) {
+          const auto second = neighbours[k];
+          const auto [res, emf] = attributes[k];
+          if (throttle::is_roughly_equal(res, 0.0)) continue;
+
+          const auto emf_fwd = emf_of(graph.label(first), graph.label(second), emf);
+          const auto fwd_current = (potentials[first] - potentials[second] + emf_fwd) / res;
+          result.currents[graph.offset(first) + k] = fwd_current;
+          leaving[first] += fwd_current;
+        }
+      }
+
+      // Short circuit currents come from KCL, walking each tree from the leaves up: whatever leaves the subtree of v
+      // through resistors has to enter it through the short circuit from the parent.
+      for (auto start = tree_order.rbegin(), finish = tree_order.rend(); start != finish; ++start) {
+        const auto v = *start, parent = tree_parent[v];
+        if (parent == no_parent) continue;
+        result.currents[tree_entry[v]] = leaving[v];
+        result.currents[graph.twin(tree_entry[v])] = -leaving[v];
+        leaving[parent] += leaving[v];
+      }
+
+      return result;
+    }
+
+    // The same solution keyed by vertex identifiers.
+    solution make_solution(const dense_solution &dense) const {
+      auto result_potentials = solution_potentials{};
+      auto result_currents = solution_currents{};
+
+      for (unsigned i = 0; i < vertices; ++i) {
+        result_potentials[graph.label(i)] = dense.potentials[i];
+        auto &adjacent = result_currents[graph.label(i)];
+
+        const auto neighbours = graph.neighbours(i);
+        for (std::size_t k = 0; k < neighbours.size(); ++k) {
+          adjacent[graph.label(neighbours[k])] = dense.currents[graph.offset(i) + k];
         }
       }
 
       return solution{result_potentials, result_currents};
     }
-  };
 
-  friend connected_resistor_network_solver;
+    dense_solution solve_dense(const solver_options &opts) const {
+      if (graph.empty()) return dense_solution{}; // If the network is empty, then there's nothing to do
 
-public:
-  // The graph passed to this constructor must consist of only one connected components. This requirement is not
-  // validated in any way whatsoever. This class is not supposed to be used by the end user.
-  connected_resistor_network(circuit_graph_type graph) : m_graph{graph} {
-    for (const auto &v : m_graph) {
-      for (const auto &p : v.second) {
-        auto first = v.first, second = p.first;
-        auto [res, emf] = p.second;
-        if (throttle::is_roughly_equal(res, 0.0)) m_short_circuits.push_back({first, second, emf});
+      // Solve the linear system of equations to find unkown potentials and currents.
+      auto res = solve_unknowns(opts);
+      if (!res) throw circuit_error{"The circuit is undefined. Possible infinite current loop"};
+      return make_dense_solution(res.value(), stored_emf());
+    }
+
+    solution solve(const solver_options &opts) const { return make_solution(solve_dense(opts)); }
+
+    // Right hand sides are solved rhs_block at a time, which bounds the memory of the blocked substitution.
+    static constexpr unsigned rhs_block = 64;
+
+    std::vector<solution> solve_batch(const std::vector<emf_assignment> &batch, const solver_options &opts) const {
+      if (graph.empty()) return std::vector<solution>(batch.size());
+
+      const auto system = make_sparse_system();
+      const auto n = system.vars();
+
+      // Step 1. Factorize once. Conjugate gradient keeps its preconditioner instead.
+      std::optional<linmath::conjugate_gradient_solver<double>> cg;
+      std::optional<linmath::sparse_lu<double>>                 sparse_lu;
+      std::optional<linmath::lu_factorization<double>>          dense_lu;
+
+      if (opts.method == solver_method::conjugate_gradient) {
+        cg.emplace(system.get_matrix(), opts.cg);
+      } else if (opts.method == solver_method::dense) {
+        if (opts.threads == 1) {
+          dense_lu.emplace(system.get_matrix().to_dense());
+        } else {
+          concurrency::thread_pool pool{opts.threads};
+          dense_lu.emplace(system.get_matrix().to_dense(), pool);
+        }
+      } else {
+        sparse_lu.emplace(system.get_matrix(linmath::sparse_format::csc));
       }
+
+      if ((sparse_lu && sparse_lu->singular()) || (dense_lu && dense_lu->singular()))
+        throw circuit_error{"The circuit is undefined. Possible infinite current loop"};
+
+      // Step 2. Substitute a block of right hand sides at a time.
+      std::vector<solution> result;
+      result.reserve(batch.size());
+
+      for (std::size_t first = 0; first < batch.size(); first += rhs_block) {
+        const auto                        count = std::min<std::size_t>(rhs_block, batch.size() - first);
+        linmath::contiguous_matrix<double> rhs{n, count};
+
+        for (std::size_t j = 0; j < count; ++j) {
+          const auto column = make_free_coeffs(assigned_emf(batch[first + j]));
+          for (std::size_t i = 0; i < n; ++i) {
+            rhs[i][j] = column[i];
+          }
+        }
+
+        std::optional<linmath::contiguous_matrix<double>> unknowns;
+        if (sparse_lu) unknowns = sparse_lu->solve_batch(rhs);
+        else if (dense_lu) unknowns = dense_lu->solve_batch(rhs);
+        else unknowns = solve_each(*cg, rhs);
+
+        for (std::size_t j = 0; j < count; ++j) {
+          std::vector<double> column(n);
+          for (std::size_t i = 0; i < n; ++i) {
+            column[i] = unknowns.value()[i][j];
+          }
+          result.push_back(make_solution(make_dense_solution(column, assigned_emf(batch[first + j]))));
+        }
+      }
+
+      return result;
     }
+
+    static linmath::contiguous_matrix<double> solve_each(linmath::conjugate_gradient_solver<double> &cg,
+                                                         const linmath::contiguous_matrix<double>   &rhs) {
+      linmath::contiguous_matrix<double> res{rhs.rows(), rhs.cols()};
+
+      for (std::size_t j = 0; j < rhs.cols(); ++j) {
+        std::vector<double> column(rhs.rows());
+        for (std::size_t i = 0; i < rhs.rows(); ++i) {
+          column[i] = rhs[i][j];
+        }
+
+        auto x = cg.solve(column);
+        if (!x) throw circuit_error{"Conjugate gradient did not converge"};
+        for (std::size_t i = 0; i < rhs.rows(); ++i) {
+          res[i][j] = x.value()[i];
+        }
+      }
+
+      return res;
+    }
+  };
+
+public:
+  // The component passed to this constructor must be connected. This requirement is not validated in any way
+  // whatsoever. The network reads the graph the view points into, so that graph has to outlive it. This class is not
+  // supposed to be used by the end user.
+  connected_resistor_network(component_type graph) : m_graph{graph} {}
+
+  const component_type &graph() const { return m_graph; }
+
+  // Solve a connected graph given in the compact form, with the ground as vertex 0. That's how the network left after
+  // a reduction comes.
+  static dense_solution solve_connected(const csr_graph_type &graph, const solver_options &opts) {
+    connected_resistor_network_solver solver{graph};
+    return solver.solve_dense(opts);
   }
 
-  circuit_graph_type graph() const { return m_graph; }
+  solution solve(solver_method method = solver_method::sparse) const { return solve(solver_options{.method = method}); }
+
+  // With opts.reduce the system is assembled for the network left after series/parallel reduction (see
+  // network_reduction.hpp), which usually has far fewer unknowns. The solution still covers every vertex and edge.
+  solution solve(const solver_options &opts) const {
+    const auto graph = csr_graph_type::from_graph(m_graph);
+    if (!opts.reduce || graph.empty()) {
+      connected_resistor_network_solver solver{graph};
+      return solver.solve(opts);
+    }
+
+    network_reduction<T> reduction{graph, 0};
+    if (!reduction.reduce()) throw circuit_error{"The circuit is undefined. Possible infinite current loop"};
+
+    auto reduced_opts = opts;
+    reduced_opts.reduce = false;
 
-  solution solve() const {
-    connected_resistor_network_solver solver{*this};
-    return solver.solve();
+    const auto reduced = reduction.reduced_graph();
+    const auto [potentials, currents] = solve_connected(reduced, reduced_opts);
+    return reduction.expand(reduced, potentials, currents);
+  }
+
+  std::vector<solution> solve_batch(const std::vector<emf_assignment> &batch, const solver_options &opts = {}) const {
+    const auto                        graph = csr_graph_type::from_graph(m_graph);
+    connected_resistor_network_solver solver{graph};
+    return solver.solve_batch(batch, opts);
   }
 };
 } // namespace detail
 
+// Solution of a network in flat arrays: the potential of every vertex by its index and the current of every edge, from
+// its first to its second vertex, by the id that insert() returned. Identifiers are mapped to indices by one table,
+// kept here, so lookups by identifier are still available. Potentials are relative to a ground in every connected
+// component.
+template <typename T> class indexed_solution {
+public:
+  using size_type = std::size_t;
+
+private:
+  std::vector<T>                   m_labels;
+  std::unordered_map<T, size_type> m_index;
+  std::vector<double>              m_potentials, m_currents;
+
+public:
+  indexed_solution() = default;
+  indexed_solution(std::vector<T> labels, std::unordered_map<T, size_type> index, std::vector<double> potentials,
+                   std::vector<double> currents)
+      : m_labels(std::move(labels)), m_index(std::move(index)), m_potentials(std::move(potentials)),
+        m_currents(std::move(currents)) {}
+
+  size_type vertices() const { return m_labels.size(); }
+  size_type edges() const { return m_currents.size(); }
+
+  const T  &label(size_type i) const { return m_labels[i]; }
+  bool      contains(const T &id) const { return m_index.contains(id); }
+  size_type index(const T &id) const { return m_index.at(id); }
+
+  double potential(size_type i) const { return m_potentials[i]; }
+  double potential_of(const T &id) const { return m_potentials[index(id)]; }
+  double current(size_type e) const { return m_currents[e]; }
+
+  const std::vector<double> &potentials() const { return m_potentials; }
+  const std::vector<double> &currents() const { return m_currents; }
+};
+
 template <typename T> class resistor_network {
 public:
   using connected_network_type = detail::connected_resistor_network<T>;
   using circuit_graph_type = typename connected_network_type::circuit_graph_type;
+  using component_partition = typename circuit_graph_type::component_partition;
   using solution_potentials = typename connected_network_type::solution_potentials;
   using solution_currents = typename connected_network_type::solution_currents;
   using solution = std::pair<solution_potentials, solution_currents>;
+  using emf_assignment = typename connected_network_type::emf_assignment;
+  using edge_id = std::size_t;
+
+  struct edge_type {
+    T      first, second;
+    double res, emf; // EMF from the first to the second vertex
+  };
+
+  struct indexed_edge {
+    std::size_t first, second; // Vertex indices
+    double      res, emf;
+  };
 
 private:
-  circuit_graph_type m_graph;
+  circuit_graph_type     m_graph; // Parallel edges are kept as their equivalent
+  std::vector<edge_type> m_edges; // Every inserted edge, indexed by its id
+  bool                   m_parallel_shorts = false; // Those have no equivalent, the currents in them are undefined
+
+  static bool is_short(resistance_emf_pair pair) { return throttle::is_roughly_equal(pair.first, 0.0); }
+
+  // Two short circuits are kept as the first one, but solving then fails, see check_defined().
+  static resistance_emf_pair parallel(resistance_emf_pair lhs, resistance_emf_pair rhs) {
+    if (is_short(lhs)) return lhs;
+    if (is_short(rhs)) return rhs;
+    const auto g_lhs = 1.0 / lhs.first, g_rhs = 1.0 / rhs.first, g = g_lhs + g_rhs;
+    return {1.0 / g, (lhs.second * g_lhs + rhs.second * g_rhs) / g};
+  }
 
-public:
-  std::vector<connected_network_type> connected_components() const {
-    auto components = m_graph.connected_components();
-    return {components.begin(), components.end()};
+  // solve_edges() rejects parallel short circuits on its own, the graph has already merged them.
+  void check_defined() const {
+    if (m_parallel_shorts) throw circuit_error{"The circuit is undefined. Possible infinite current loop"};
+  }
+
+  // Labelling runs in parallel only with more than one thread, and only pays off for large networks.
+  template <typename E>
+  static containers::component_labelling label_components(std::size_t n, const std::vector<E> &edges,
+                                                           const solver_options &opts) {
+    constexpr std::size_t parallel_threshold = 1 << 18;
+    if (opts.threads == 1 || edges.size() < parallel_threshold) return containers::label_components(n, edges);
+
+    concurrency::thread_pool pool{opts.threads};
+    return containers::label_components(n, edges, pool);
+  }
+
+  // Calls work(i, opts) for every component i. With more than one thread and component they run concurrently,
+  // largest first, so that a giant component doesn't start last. The pool's queue is FIFO, so submission order is
+  // start order. Components then get a single thread each, otherwise they'd oversubscribe the cores.
+  template <typename F>
+  static void for_each_component(const std::vector<std::size_t> &sizes, const solver_options &opts, F work) {
+    std::vector<std::size_t> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    if (opts.threads == 1 || sizes.size() < 2) {
+      for (const auto i : order) {
+        work(i, opts);
+      }
+      return;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&sizes](auto lhs, auto rhs) { return sizes[lhs] > sizes[rhs]; });
+
+    auto component_opts = opts;
+    component_opts.threads = 1;
+
+    concurrency::thread_pool pool{opts.threads};
+    concurrency::task_graph  graph;
+    for (const auto i : order) {
+      graph.add([&work, &component_opts, i] { work(i, component_opts); });
+    }
+
+    graph.run(pool);
   }
 
-  circuit_graph_type graph() const { return m_graph; }
+public:
+  // Components are views into this network, so they are valid while it's alive and not modified.
+  component_partition connected_components() const { return m_graph.connected_components(); }
+
+  const circuit_graph_type     &graph() const { return m_graph; }
+  const std::vector<edge_type> &edges() const { return m_edges; }
+
+  solution solve(solver_method method = solver_method::sparse) const { return solve(solver_options{.method = method}); }
+
+  // Potentials and currents between pairs of vertices. For parallel edges that's the total current through them.
+  solution solve(const solver_options &opts) const {
+    check_defined();
+
+    const auto               components = connected_components();
+    std::vector<solution>    solutions(components.size());
+    std::vector<std::size_t> sizes;
+
+    for (const auto &comp : components) {
+      sizes.push_back(comp.vertices() + comp.edges());
+    }
+
+    for_each_component(sizes, opts, [&](std::size_t i, const solver_options &component_opts) {
+      solutions[i] = connected_network_type{components[i]}.solve(component_opts);
+    });
 
-  solution solve() const {
-    auto     components = connected_components();
     solution result;
+    for (auto &sol : solutions) {
+      result.first.merge(sol.first);
+      result.second.merge(sol.second);
+    }
+
+    return result;
+  }
+
+  // Solve the same circuit for every set of EMFs in batch. Each component is factorized once and then all right hand
+  // sides go through a blocked substitution, so the batch costs about one factorization plus batch.size() solves. The
+  // i-th solution corresponds to batch[i].
+  std::vector<solution> solve_batch(const std::vector<emf_assignment> &batch, const solver_options &opts = {}) const {
+    check_defined();
+
+    const auto            components = connected_components();
+    std::vector<solution> result(batch.size());
 
     for (const auto &comp : components) {
-      auto individual_sol = comp.solve();
-      result.first.merge(individual_sol.first);
-      result.second.merge(individual_sol.second);
+      auto individual_sols = connected_network_type{comp}.solve_batch(batch, opts);
+      for (std::size_t i = 0; i < batch.size(); ++i) {
+        result[i].first.merge(individual_sols[i].first);
+        result[i].second.merge(individual_sols[i].second);
+      }
     }
 
     return result;
   }
 
-  void insert(T first, T second, double resistance = 0, double emf = 0) {
-    resistance_emf_pair fwd_pair = {resistance, emf}, bck_pair = {resistance, -emf};
-    m_graph.insert_edge({first, second}, fwd_pair, bck_pair);
+  // Current of every edge from its first to its second vertex, indexed by the id that insert() returned. Parallel
+  // edges and self loops get their own currents, and nothing is hashed per edge on the way out.
+  std::vector<double> solve_edges(const solver_options &opts = {}) const { return solve_indexed(opts).currents(); }
+
+  // Potentials and currents in flat arrays, see indexed_solution. This is solve() without the nested hash maps.
+  indexed_solution<T> solve_indexed(const solver_options &opts = {}) const {
+    std::unordered_map<T, std::size_t> index;
+    std::vector<T>                     labels;
+
+    const auto index_of = [&index, &labels](const T &id) {
+      const auto [found, inserted] = index.try_emplace(id, labels.size());
+      if (inserted) labels.push_back(id);
+      return found->second;
+    };
+
+    std::vector<indexed_edge> edges;
+    edges.reserve(m_edges.size());
+    for (const auto &e : m_edges) {
+      edges.push_back({index_of(e.first), index_of(e.second), e.res, e.emf});
+    }
+
+    return solve_indexed(std::move(labels), std::move(index), edges, opts);
+  }
+
+  // Same for edges whose vertices are already numbered 0, 1, ..., labels.size() - 1, with index mapping the labels
+  // back. This is what network_builder collects.
+  static indexed_solution<T> solve_indexed(std::vector<T> labels, std::unordered_map<T, std::size_t> index,
+                                           const std::vector<indexed_edge> &edges, const solver_options &opts = {}) {
+    using reduction_type = detail::network_reduction<T>;
+    using branch = typename reduction_type::branch;
+
+    // Step 1. Split the edges into connected components.
+    const auto labelling = label_components(labels.size(), edges, opts);
+    const auto count = labelling.size();
+    const auto &component = labelling.component;
+
+    std::vector<std::size_t>              local(labels.size());
+    std::vector<std::vector<std::size_t>> component_vertices(count);
+    std::vector<std::vector<branch>>      component_branches(count);
+    std::vector<std::vector<edge_id>>     component_edges(count);
+
+    for (std::size_t i = 0; i < labels.size(); ++i) {
+      auto &vertices = component_vertices[component[i]];
+      vertices.reserve(labelling.vertices[component[i]]);
+      local[i] = vertices.size();
+      vertices.push_back(i);
+    }
+
+    std::vector<double> potentials(labels.size()), currents(edges.size());
+    for (edge_id e = 0; e < edges.size(); ++e) {
+      const auto &edge = edges[e];
+      const auto  first = edge.first, second = edge.second;
+
+      // A self loop is a circuit on its own.
+      if (first == second) {
+        if (throttle::is_roughly_equal(edge.res, 0.0))
+          throw circuit_error{"The circuit is undefined. Possible infinite current loop"};
+        currents[e] = edge.emf / edge.res;
+        continue;
+      }
+
+      const auto c = component[first];
+      component_branches[c].push_back({local[first], local[second], edge.res, edge.emf});
+      component_edges[c].push_back(e);
+    }
+
+    // Step 2. Solve each component on its reduced simple graph and expand the solution back to the vertices and edges.
+    // Components own disjoint sets of both, so they write their results without synchronization.
+    std::vector<std::size_t> sizes(count);
+    for (std::size_t c = 0; c < count; ++c) {
+      sizes[c] = labelling.vertices[c] + labelling.edges[c];
+    }
+
+    for_each_component(sizes, opts, [&](std::size_t c, const solver_options &component_opts) {
+      if (component_edges[c].empty()) return;
+
+      const auto    &vertices = component_vertices[c];
+      std::vector<T> component_labels;
+      component_labels.reserve(vertices.size());
+      for (const auto i : vertices) {
+        component_labels.push_back(labels[i]);
+      }
+
+      reduction_type reduction{std::move(component_labels), std::move(component_branches[c]), 0};
+      if (!reduction.reduce(component_opts.reduce))
+        throw circuit_error{"The circuit is undefined. Possible infinite current loop"};
+
+      auto reduced_opts = component_opts;
+      reduced_opts.reduce = false;
+
+      const auto reduced = reduction.reduced_graph();
+      const auto dense = connected_network_type::solve_connected(reduced, reduced_opts);
+      const auto [phi, edge_currents] = reduction.expand_dense(reduced, dense.potentials, dense.currents);
+
+      for (std::size_t k = 0; k < vertices.size(); ++k) {
+        potentials[vertices[k]] = phi[k];
+      }
+
+      for (std::size_t k = 0; k < edge_currents.size(); ++k) {
+        currents[component_edges[c][k]] = edge_currents[k];
+      }
+    });
+
+    return {std::move(labels), std::move(index), std::move(potentials), std::move(currents)};
+  }
+
+  // Every call adds a new edge, so inserting the same pair twice gives two resistors in parallel. Returns the id of
+  // the edge in edges() and solve_edges().
+  edge_id insert(T first, T second, double resistance = 0, double emf = 0) {
+    if (first != second) {
+      resistance_emf_pair fwd_pair = {resistance, emf};
+      if (auto found = m_graph.lookup_edge({first, second})) {
+        m_parallel_shorts |= (is_short(found->first->second) && is_short(fwd_pair));
+        fwd_pair = parallel(found->first->second, fwd_pair);
+      }
+      m_graph.insert_edge({first, second}, fwd_pair, {fwd_pair.first, -fwd_pair.second});
+    }
+
+    m_edges.push_back({first, second, resistance, emf});
+    return m_edges.size() - 1;
   }
 };
 
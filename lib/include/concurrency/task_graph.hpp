@@ -0,0 +1,119 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Static DAG of tasks executed on a thread_pool.
+ * The graph is built up front with add() and depends(), then run() submits every task whose predecessors have finished
+ * and blocks until the whole graph is done. A task is submitted by the worker that completes its last predecessor, so
+ * there's no central scheduler thread. If a task throws, the remaining ones are skipped and the first exception is
+ * rethrown from run(). run() must not be called from a worker of the same pool.
+ */
+
+#pragma once
+
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace throttle::concurrency {
+
+class task_graph final {
+public:
+  using size_type = std::size_t;
+  using task_type = std::function<void()>;
+
+private:
+  struct task_node {
+    task_type              m_work;
+    std::vector<size_type> m_successors;
+    size_type              m_predecessors = 0;
+  };
+
+  std::vector<task_node> m_nodes;
+
+  struct run_state {
+    std::vector<std::atomic<size_type>> m_pending;
+    std::atomic<size_type>              m_remaining;
+    std::atomic<bool>                   m_failed = false;
+    std::exception_ptr                  m_exception;
+    bool                                m_finished = false; // Guarded by m_mutex, so run() can't return too early
+    std::mutex                          m_mutex;
+    std::condition_variable             m_done;
+
+    run_state(size_type size) : m_pending(size), m_remaining{size} {}
+  };
+
+  void execute(size_type index, run_state &state, thread_pool &pool) {
+    if (!state.m_failed.load(std::memory_order_relaxed)) {
+      try {
+        m_nodes[index].m_work();
+      } catch (...) {
+        std::lock_guard lock{state.m_mutex};
+        if (!state.m_failed.exchange(true)) state.m_exception = std::current_exception();
+      }
+    }
+
+    for (const auto next : m_nodes[index].m_successors) {
+      if (state.m_pending[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        pool.submit([this, next, &state, &pool] { execute(next, state, pool); });
+      }
+    }
+
+    if (state.m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard lock{state.m_mutex};
+      state.m_finished = true;
+      state.m_done.notify_all();
+    }
+  }
+
+public:
+  size_type size() const { return m_nodes.size(); }
+
+  size_type add(task_type work) {
+    m_nodes.push_back({std::move(work), {}, 0});
+    return m_nodes.size() - 1;
+  }
+
+  // Task `after` can only start once task `before` has finished.
+  void depends(size_type after, size_type before) {
+    if (after >= size() || before >= size()) throw std::out_of_range("Task index out of range");
+    m_nodes[before].m_successors.push_back(after);
+    ++m_nodes[after].m_predecessors;
+  }
+
+  void run(thread_pool &pool) {
+    if (m_nodes.empty()) return;
+
+    run_state state{size()};
+    for (size_type i = 0; i < size(); ++i) {
+      state.m_pending[i].store(m_nodes[i].m_predecessors, std::memory_order_relaxed);
+    }
+
+    for (size_type i = 0; i < size(); ++i) {
+      if (m_nodes[i].m_predecessors == 0) pool.submit([this, i, &state, &pool] { execute(i, state, pool); });
+    }
+
+    {
+      std::unique_lock lock{state.m_mutex};
+      state.m_done.wait(lock, [&state] { return state.m_finished; });
+    }
+
+    if (state.m_exception) std::rethrow_exception(state.m_exception);
+  }
+};
+
+} // namespace throttle::concurrency
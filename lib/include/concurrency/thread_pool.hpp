@@ -0,0 +1,94 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Fixed size pool of worker threads fed from a single FIFO queue.
+ * Tasks are type-erased into std::function and must not throw, wrap them if they can. The destructor drains the queue
+ * before joining the workers.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace throttle::concurrency {
+
+class thread_pool final {
+public:
+  using size_type = std::size_t;
+  using task_type = std::function<void()>;
+
+private:
+  std::vector<std::thread> m_workers;
+  std::deque<task_type>    m_tasks;
+  std::mutex               m_mutex;
+  std::condition_variable  m_cv;
+  bool                     m_stop = false;
+
+  void worker_loop() {
+    while (true) {
+      task_type task;
+
+      {
+        std::unique_lock lock{m_mutex};
+        m_cv.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+        if (m_tasks.empty()) return;
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+      }
+
+      task();
+    }
+  }
+
+public:
+  // Zero threads means one per hardware thread.
+  explicit thread_pool(size_type threads = 0) {
+    if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+    m_workers.reserve(threads);
+    for (size_type i = 0; i < threads; ++i) {
+      m_workers.emplace_back([this] { worker_loop(); });
+    }
+  }
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  ~thread_pool() {
+    {
+      std::lock_guard lock{m_mutex};
+      m_stop = true;
+    }
+
+    m_cv.notify_all();
+    for (auto &worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  size_type size() const { return m_workers.size(); }
+
+  void submit(task_type task) {
+    {
+      std::lock_guard lock{m_mutex};
+      m_tasks.push_back(std::move(task));
+    }
+    m_cv.notify_one();
+  }
+};
+
+} // namespace throttle::concurrency
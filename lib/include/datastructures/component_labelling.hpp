@@ -0,0 +1,118 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Connected components of a flat edge list over the vertices 0, 1, ..., n - 1.
+ * The parallel version is the union-find form of Shiloach-Vishkin. Chunks of edges hook the roots of their ends
+ * concurrently, always under the root with the smaller index (see concurrent_disjoint_set_forest.hpp). Then chunks of
+ * vertices find their roots with path halving, which is SV's shortcutting step. A sequential scan then numbers the
+ * components in the order of their smallest vertex, and a last one counts the edges. Both scans are O(V + E) with no
+ * hashing and read the arrays in order.
+ */
+
+#pragma once
+
+#include "concurrency/task_graph.hpp"
+#include "concurrency/thread_pool.hpp"
+#include "datastructures/concurrent_disjoint_set_forest.hpp"
+#include "datastructures/dense_disjoint_set_forest.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace throttle::containers {
+
+struct component_labelling {
+  using size_type = std::size_t;
+
+  std::vector<size_type> component;       // Of every vertex, numbered in the order of their smallest vertex
+  std::vector<size_type> vertices, edges; // Of every component, self loops included
+
+  size_type size() const { return vertices.size(); }
+};
+
+namespace detail {
+
+// Number the components given the root of every vertex.
+template <typename E>
+component_labelling number_components(std::vector<std::size_t> roots, const std::vector<E> &edges) {
+  constexpr auto           none = static_cast<std::size_t>(-1);
+  component_labelling      result;
+  std::vector<std::size_t> label(roots.size(), none);
+
+  result.component = std::move(roots);
+  for (std::size_t i = 0; i < result.component.size(); ++i) {
+    auto &root_label = label[result.component[i]];
+    if (root_label == none) {
+      root_label = result.size();
+      result.vertices.push_back(0);
+      result.edges.push_back(0);
+    }
+
+    result.component[i] = root_label;
+    ++result.vertices[root_label];
+  }
+
+  for (const auto &e : edges) {
+    ++result.edges[result.component[e.first]];
+  }
+
+  return result;
+}
+
+template <typename F>
+void parallel_chunks(std::size_t size, std::size_t chunk, concurrency::thread_pool &pool, F func) {
+  concurrency::task_graph graph;
+  for (std::size_t first = 0; first < size; first += chunk) {
+    graph.add([&func, first, last = std::min(size, first + chunk)] { func(first, last); });
+  }
+  graph.run(pool);
+}
+
+} // namespace detail
+
+// Edges are anything with first and second members, every vertex has to be less than n.
+template <typename E> component_labelling label_components(std::size_t n, const std::vector<E> &edges) {
+  dense_disjoint_set_forest dsu{n};
+  for (const auto &e : edges) {
+    dsu.union_set(e.first, e.second);
+  }
+
+  std::vector<std::size_t> roots(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    roots[i] = dsu.find_set(i);
+  }
+
+  return detail::number_components(std::move(roots), edges);
+}
+
+template <typename E>
+component_labelling label_components(std::size_t n, const std::vector<E> &edges, concurrency::thread_pool &pool) {
+  constexpr std::size_t chunk = 1 << 16;
+
+  concurrent_disjoint_set_forest dsu{n};
+  detail::parallel_chunks(edges.size(), chunk, pool, [&](std::size_t first, std::size_t last) {
+    for (auto i = first; i < last; ++i) {
+      dsu.union_set(edges[i].first, edges[i].second);
+    }
+  });
+
+  std::vector<std::size_t> roots(n);
+  detail::parallel_chunks(n, chunk, pool, [&](std::size_t first, std::size_t last) {
+    for (auto i = first; i < last; ++i) {
+      roots[i] = dsu.find_set(i);
+    }
+  });
+
+  return detail::number_components(std::move(roots), edges);
+}
+
+} // namespace throttle::containers
@@ -0,0 +1,85 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Lock-free disjoint sets of the integers 0, 1, ..., n - 1.
+ * Parent links are atomics and every change to them is a compare-and-swap, so any number of threads can call find_set
+ * and union_set at the same time. A root is linked only by a CAS that expects it to still be a root, and always under
+ * the root with the smaller index, which rules out cycles. Sizes can't be kept consistent without locks, so unlike
+ * dense_disjoint_set_forest there's no union by size; path halving keeps the trees shallow in practice. Path halving
+ * may lose a race, which only means that a path is shortened later.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace throttle::containers {
+
+class concurrent_disjoint_set_forest final {
+public:
+  using size_type = std::size_t;
+
+private:
+  std::unique_ptr<std::atomic<size_type>[]> m_parent;
+  size_type                                 m_size = 0;
+
+  size_type parent(size_type x) const { return m_parent[x].load(std::memory_order_acquire); }
+
+public:
+  explicit concurrent_disjoint_set_forest(size_type n = 0)
+      : m_parent{std::make_unique<std::atomic<size_type>[]>(n)}, m_size{n} {
+    for (size_type i = 0; i < n; ++i) {
+      m_parent[i].store(i, std::memory_order_relaxed);
+    }
+  }
+
+  size_type size() const { return m_size; }
+
+  // The root may stop being one as soon as this returns, if another thread links it.
+  size_type find_set(size_type x) {
+    while (true) {
+      auto up = parent(x);
+      const auto grand = parent(up);
+      if (up == grand) return up;
+
+      m_parent[x].compare_exchange_weak(up, grand, std::memory_order_acq_rel, std::memory_order_relaxed);
+      x = grand;
+    }
+  }
+
+  // Returns false if the two were already in the same set. Of all concurrent calls that join the same pair of sets
+  // exactly one returns true.
+  bool union_set(size_type left, size_type right) {
+    while (true) {
+      left = find_set(left);
+      right = find_set(right);
+      if (left == right) return false;
+
+      if (left < right) std::swap(left, right);
+      auto expected = left;
+      if (m_parent[left].compare_exchange_strong(expected, right, std::memory_order_acq_rel)) return true;
+    }
+  }
+
+  bool same_set(size_type left, size_type right) {
+    while (true) {
+      left = find_set(left);
+      right = find_set(right);
+      if (left == right) return true;
+      // Still a root, so the sets really were different at this point.
+      if (parent(left) == left) return false;
+    }
+  }
+};
+
+} // namespace throttle::containers
@@ -0,0 +1,136 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Frozen graph in compressed sparse row form.
+ * Vertices are numbered 0, 1, ... and the neighbours of vertex i are m_neighbours[m_offsets[i], m_offsets[i + 1]), with
+ * the attribute of the edge towards each of them at the same position of m_attributes. Like in ud_asymmetric_graph
+ * every edge is stored from both ends, with the forward and the backward attribute. A position in these arrays is an
+ * entry, and the entry of the same edge seen from the other end is its twin, so data per entry (currents, say) can be
+ * kept in flat arrays too. The graph can't be modified once it's built, but traversals read contiguous arrays, there's
+ * no allocation per vertex or edge and the degree of a vertex is O(1).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace throttle::containers {
+
+template <typename T, typename U> class csr_graph {
+public:
+  using size_type = std::size_t;
+
+  struct edge {
+    size_type first, second;
+    U         fwd, bck;
+  };
+
+private:
+  std::vector<T>         m_labels;
+  std::vector<size_type> m_offsets = {0}, m_neighbours, m_twins;
+  std::vector<size_type> m_edge_entries; // Forward entry of every edge in the order they were given
+  std::vector<U>         m_attributes;
+
+public:
+  csr_graph() = default;
+
+  // Vertices are given by their index into labels. Parallel edges are kept apart and a self loop is listed twice in
+  // its own vertex.
+  csr_graph(std::vector<T> labels, const std::vector<edge> &edges) : m_labels(std::move(labels)) {
+    const auto n = m_labels.size();
+    m_offsets.assign(n + 1, 0);
+
+    for (const auto &e : edges) {
+      if (e.first >= n || e.second >= n) throw std::out_of_range{"Edge refers to a vertex that isn't in the graph"};
+      ++m_offsets[e.first + 1];
+      ++m_offsets[e.second + 1];
+    }
+
+    std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+    m_neighbours.resize(m_offsets.back());
+    m_attributes.resize(m_offsets.back());
+    m_twins.resize(m_offsets.back());
+    m_edge_entries.reserve(edges.size());
+
+    std::vector<size_type> next(m_offsets.begin(), m_offsets.end() - 1);
+    for (const auto &e : edges) {
+      const auto fwd = next[e.first]++;
+      m_neighbours[fwd] = e.second;
+      m_attributes[fwd] = e.fwd;
+
+      const auto bck = next[e.second]++;
+      m_neighbours[bck] = e.first;
+      m_attributes[bck] = e.bck;
+
+      m_twins[fwd] = bck;
+      m_twins[bck] = fwd;
+      m_edge_entries.push_back(fwd);
+    }
+  }
+
+  // From anything that iterates like ud_asymmetric_graph, a component view in particular: pairs of a vertex and a map
+  // from its neighbours to attributes. Vertices are numbered in the order of iteration and every neighbour has to be
+  // one of them. Edges are numbered in the order they are met from their end with the smaller index.
+  template <typename G> static csr_graph from_graph(const G &graph) {
+    using adjacency_type = std::remove_cvref_t<decltype(graph.begin()->second)>;
+
+    std::vector<T>                      labels;
+    std::vector<const adjacency_type *> adjacency;
+    std::unordered_map<T, size_type>    index;
+    std::vector<edge>                   edges;
+
+    for (const auto &v : graph) {
+      index[v.first] = labels.size();
+      labels.push_back(v.first);
+      adjacency.push_back(&v.second);
+    }
+
+    for (size_type first = 0; first < labels.size(); ++first) {
+      for (const auto &[id, attr] : *adjacency[first]) {
+        const auto second = index.at(id);
+        if (first < second) edges.push_back({first, second, attr, adjacency[second]->at(labels[first])});
+      }
+    }
+
+    return {std::move(labels), edges};
+  }
+
+  size_type vertices() const { return m_labels.size(); }
+  size_type edges() const { return m_neighbours.size() / 2; }
+  bool      empty() const { return (vertices() == 0); }
+
+  size_type degree(size_type i) const { return m_offsets[i + 1] - m_offsets[i]; }
+  size_type entries() const { return m_neighbours.size(); }
+
+  // The k-th neighbour of i is entry offset(i) + k.
+  size_type offset(size_type i) const { return m_offsets[i]; }
+  size_type twin(size_type entry) const { return m_twins[entry]; }
+  size_type edge_entry(size_type edge) const { return m_edge_entries[edge]; }
+
+  const T              &label(size_type i) const { return m_labels[i]; }
+  const std::vector<T> &labels() const { return m_labels; }
+
+  std::span<const size_type> neighbours(size_type i) const {
+    return {m_neighbours.data() + m_offsets[i], m_neighbours.data() + m_offsets[i + 1]};
+  }
+
+  std::span<const U> attributes(size_type i) const {
+    return {m_attributes.data() + m_offsets[i], m_attributes.data() + m_offsets[i + 1]};
+  }
+};
+
+} // namespace throttle::containers
@@ -0,0 +1,63 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Disjoint sets of the integers 0, 1, ..., n - 1.
+ * Two flat arrays and no hashing. Find_set is iterative with path halving and union is by size, which keeps the trees
+ * O(log n) deep without any recursion. concurrent_disjoint_set_forest.hpp has a variant that threads can share.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace throttle::containers {
+
+class dense_disjoint_set_forest final {
+public:
+  using size_type = std::size_t;
+
+private:
+  std::vector<size_type> m_parent, m_size;
+
+public:
+  explicit dense_disjoint_set_forest(size_type n = 0) : m_parent(n), m_size(n, 1) {
+    std::iota(m_parent.begin(), m_parent.end(), 0);
+  }
+
+  size_type size() const { return m_parent.size(); }
+
+  size_type find_set(size_type x) {
+    while (m_parent[x] != x) {
+      m_parent[x] = m_parent[m_parent[x]];
+      x = m_parent[x];
+    }
+    return x;
+  }
+
+  // Returns false if the two were already in the same set.
+  bool union_set(size_type left, size_type right) {
+    left = find_set(left);
+    right = find_set(right);
+    if (left == right) return false;
+
+    if (m_size[left] < m_size[right]) std::swap(left, right);
+    m_parent[right] = left;
+    m_size[left] += m_size[right];
+    return true;
+  }
+
+  bool      same_set(size_type left, size_type right) { return find_set(left) == find_set(right); }
+  size_type set_size(size_type x) { return m_size[find_set(x)]; }
+};
+
+} // namespace throttle::containers
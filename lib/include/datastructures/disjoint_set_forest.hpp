@@ -10,8 +10,9 @@
 
 /* NOTE[]: This file is not used for offline RMQ.
  * This file contains a general-purpose Disjoint Set Union structure without a mapped type. Find_set algorithm
- * implements recursive (or iterative) path compression and union by rank. A unordered_map is used to map keys to the
- * corresponding indexes in the underlying std::vector.
+ * implements iterative path halving and union by rank, so long chains don't grow the stack. A unordered_map is used to
+ * map keys to the corresponding indexes in the underlying std::vector. For keys that are already 0, 1, ..., n - 1 see
+ * dense_disjoint_set_forest.hpp, which does without the hashing.
  *
  */
 
@@ -23,8 +24,6 @@
 #include <utility>
 #include <vector>
 
-#include <stack>
-
 namespace throttle::containers {
 
 namespace detail {
@@ -63,17 +62,21 @@ public:
   }
 
 private:
-  node_type &at_index(size_type p_index) { return m_node_vec.at(p_index); }
-  size_type &parent_index(size_type p_node) { return at_index(p_node).m_parent_index; }
+  node_type       &at_index(size_type p_index) { return m_node_vec[p_index]; }
+  const node_type &at_index(size_type p_index) const { return m_node_vec[p_index]; }
 
+  // Path halving: every node on the way points to its grandparent afterwards.
   size_type find_set_impl(size_type p_node) {
-    size_type &parent = parent_index(p_node);
-    if (parent != p_node) parent = find_set_impl(parent);
-    return parent;
+    while (at_index(p_node).m_parent_index != p_node) {
+      auto &parent = at_index(p_node).m_parent_index;
+      parent = at_index(parent).m_parent_index;
+      p_node = parent;
+    }
+    return p_node;
   }
 
   void link(size_type p_left, size_type p_right) {
-    node_type &left = at_index(p_left), right = at_index(p_right);
+    node_type &left = at_index(p_left), &right = at_index(p_right);
     if (left.m_rank > right.m_rank)
       right.m_parent_index = p_left;
 
@@ -88,7 +91,7 @@ public:
 
   void union_set(const key_type &p_left, const key_type &p_right) {
     size_type left = find_set_impl(m_key_index_map.at(p_left)), right = find_set_impl(m_key_index_map.at(p_right));
-    if (p_left != p_right) link(left, right);
+    if (left != right) link(left, right);
   }
 
   template <typename t_stream> void dump(t_stream &p_ostream) const {
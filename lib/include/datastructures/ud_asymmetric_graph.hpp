@@ -10,14 +10,17 @@
 
 #pragma once
 
-#include "disjoint_set_forest.hpp"
 #include "vector.hpp"
 
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <optional>
 #include <stdexcept>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 namespace throttle::containers {
 
@@ -125,41 +128,109 @@ public:
     return std::nullopt;
   }
 
-  std::vector<self_type> connected_components() const {
-    containers::disjoint_set_forest<T> dsu;
-
-    for (const auto &v : m_vertices) {
-      dsu.make_set(v.first);
-    }
-
-    for (const auto &v : m_vertices) {
-      for (const auto &p : v.second) {
-        // Here we do double work because each edge is visited twice, but this part isn't perfomance critical.
-        dsu.union_set(v.first, p.first);
+  // One connected component as a range over its vertices. It doesn't own or copy anything: it's a slice of the vertex
+  // order in a component_partition, valid while the partition and the graph are alive and the graph isn't modified.
+  class component_view {
+  public:
+    class iterator {
+      const const_iterator *m_ptr = nullptr;
+
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = typename decltype(m_vertices)::value_type;
+      using pointer = const value_type *;
+      using reference = const value_type &;
+
+      iterator() = default;
+      iterator(const const_iterator *ptr) : m_ptr{ptr} {}
+
+      reference operator*() const { return **m_ptr; }
+      pointer   operator->() const { return &**m_ptr; }
+
+      iterator &operator++() {
+        ++m_ptr;
+        return *this;
       }
-    }
 
-    std::unordered_map<T, self_type> connected_representatives;
-    // find_set does not change the component representaive. Here we iterate over all the nodes and find their
-    // representaive to find all connected components.
-    for (const auto &v : m_vertices) {
-      const auto &found = dsu.find_set(v.first);
-      if (connected_representatives.contains(found)) continue;
-      connected_representatives.insert({found, self_type{}});
-    }
+      iterator operator++(int) {
+        auto tmp = *this;
+        ++m_ptr;
+        return tmp;
+      }
 
-    for (const auto &v : m_vertices) {
-      const auto &found = dsu.find_set(v.first);
-      connected_representatives[found].insert_vertex(v.first);
-      for (const auto &p : v.second) {
-        auto [fwd_edge, bck_edge] = lookup_edge({v.first, p.first}).value();
-        connected_representatives[found].insert_edge({v.first, p.first}, fwd_edge->second, bck_edge->second);
+      bool operator==(const iterator &) const = default;
+    };
+
+  private:
+    const const_iterator *m_first = nullptr, *m_last = nullptr;
+    size_type             m_edges = 0;
+
+  public:
+    component_view() = default;
+    component_view(const const_iterator *first, const const_iterator *last, size_type edges)
+        : m_first{first}, m_last{last}, m_edges{edges} {}
+
+    iterator begin() const { return m_first; }
+    iterator end() const { return m_last; }
+
+    size_type vertices() const { return m_last - m_first; }
+    size_type edges() const { return m_edges; }
+    bool      empty() const { return (vertices() == 0); }
+  };
+
+  // Vertices of the graph grouped by connected component. The views point into this object, so it can be moved but
+  // not copied.
+  class component_partition {
+    std::vector<const_iterator> m_order;
+    std::vector<component_view> m_components;
+
+    friend class ud_asymmetric_graph;
+
+  public:
+    component_partition() = default;
+    component_partition(const component_partition &) = delete;
+    component_partition &operator=(const component_partition &) = delete;
+    component_partition(component_partition &&) = default;
+    component_partition &operator=(component_partition &&) = default;
+
+    size_type             size() const { return m_components.size(); }
+    const component_view &operator[](size_type i) const { return m_components[i]; }
+
+    auto begin() const { return m_components.cbegin(); }
+    auto end() const { return m_components.cend(); }
+  };
+
+  // Components are labelled with a breadth first walk, which looks every vertex up once per incident edge. Within a
+  // component vertices come in the order of the walk, so the first one is the vertex it started from.
+  component_partition connected_components() const {
+    component_partition    result;
+    std::unordered_set<T>  visited;
+    std::vector<size_type> offsets{0}, edges;
+
+    result.m_order.reserve(vertices());
+    for (auto start = m_vertices.begin(), finish = m_vertices.end(); start != finish; ++start) {
+      if (!visited.insert(start->first).second) continue;
+      size_type degrees = 0;
+
+      result.m_order.push_back(start);
+      for (auto k = offsets.back(); k < result.m_order.size(); ++k) {
+        const auto &adjacent = result.m_order[k]->second;
+        degrees += adjacent.size();
+
+        for (const auto &p : adjacent) {
+          if (visited.insert(p.first).second) result.m_order.push_back(m_vertices.find(p.first));
+        }
       }
+
+      offsets.push_back(result.m_order.size());
+      edges.push_back(degrees / 2);
     }
 
-    std::vector<self_type> result;
-    for (const auto &v : connected_representatives) {
-      result.push_back(std::move(v.second));
+    // The order is complete, so the pointers into it are stable from here on.
+    for (size_type i = 0; i < edges.size(); ++i) {
+      const auto data = result.m_order.data();
+      result.m_components.emplace_back(data + offsets[i], data + offsets[i + 1], edges[i]);
     }
 
     return result;
@@ -0,0 +1,247 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Preconditioned conjugate gradient for symmetric positive definite sparse matrices.
+ * A grounded resistor network without short circuits produces exactly such a matrix. Everything here needs O(nnz)
+ * memory: the matrix itself, a handful of work vectors and a preconditioner that has at most the pattern of the lower
+ * triangle of A, or a multigrid hierarchy a small constant factor larger than A. Incomplete Cholesky needs O(sqrt(n))
+ * iterations on a 2D mesh, while a multigrid V-cycle keeps the iteration count nearly independent of the mesh size.
+ */
+
+#pragma once
+
+#include "algebraic_multigrid.hpp"
+#include "sparse_matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace throttle::linmath {
+
+enum class preconditioner_kind { none, jacobi, incomplete_cholesky, algebraic_multigrid };
+
+template <std::floating_point T> struct conjugate_gradient_options {
+  T                    tolerance = 1e-10;  // Stop when ||b - A * x|| <= tolerance * ||b||
+  std::size_t          max_iterations = 0; // Zero means the size of the system
+  preconditioner_kind  preconditioner = preconditioner_kind::incomplete_cholesky;
+  multigrid_options<T> multigrid = {}; // Only used by preconditioner_kind::algebraic_multigrid
+};
+
+namespace detail {
+
+template <std::floating_point T> T dot(const std::vector<T> &a, const std::vector<T> &b) {
+  return std::inner_product(a.begin(), a.end(), b.begin(), T{});
+}
+
+template <std::floating_point T> class jacobi_preconditioner {
+  std::vector<T> m_inv_diag;
+
+public:
+  jacobi_preconditioner(const sparse_matrix<T> &mat) : m_inv_diag(mat.rows(), T{1}) {
+    for (std::size_t i = 0; i < mat.rows(); ++i) {
+      const auto diag = mat.at(i, i);
+      if (diag > T{}) m_inv_diag[i] = T{1} / diag;
+    }
+  }
+
+  void apply(const std::vector<T> &r, std::vector<T> &z) const {
+    std::transform(r.begin(), r.end(), m_inv_diag.begin(), z.begin(), std::multiplies<T>{});
+  }
+};
+
+// Zero fill-in incomplete Cholesky A ~ L * L^T. L is kept in CSR with the same pattern as the lower triangle of A and
+// the diagonal stored last in each row. For M-matrices (like grounded Laplacians) the factorization always exists,
+// otherwise the diagonal is shifted until all pivots become positive.
+template <std::floating_point T> class incomplete_cholesky_preconditioner {
+  using size_type = std::size_t;
+
+  std::vector<size_type> m_offsets, m_indices;
+  std::vector<T>         m_values;
+
+  bool factorize(const sparse_matrix<T> &csr, T shift) {
+    const auto n = csr.rows();
+
+    m_offsets.assign(1, 0);
+    m_indices.clear();
+    m_values.clear();
+
+    for (size_type i = 0; i < n; ++i) {
+      T diag{};
+      for (auto p = csr.offsets()[i]; p < csr.offsets()[i + 1]; ++p) {
+        const auto j = csr.indices()[p];
+        if (j < i) {
+          m_indices.push_back(j);
+          m_values.push_back(csr.values()[p]);
+        } else if (j == i) {
+          diag = csr.values()[p];
+        }
+      }
+
+      const auto row_start = m_offsets.back();
+      const auto row_finish = m_indices.size();
+
+      // L(i, k) = (A(i, k) - sum L(i, j) * L(k, j)) / L(k, k) for j < k, restricted to the pattern of row i.
+      for (auto p = row_start; p < row_finish; ++p) {
+        const auto k = m_indices[p];
+        auto       q = m_offsets[k];
+        const auto q_finish = m_offsets[k + 1] - 1;
+
+        T sum = m_values[p];
+        for (auto s = row_start; s < p && q < q_finish;) {
+          if (m_indices[s] == m_indices[q]) sum -= m_values[s++] * m_values[q++];
+          else if (m_indices[s] < m_indices[q]) ++s;
+          else ++q;
+        }
+
+        m_values[p] = sum / m_values[q_finish];
+      }
+
+      T pivot = diag * (T{1} + shift);
+      for (auto p = row_start; p < row_finish; ++p) {
+        pivot -= m_values[p] * m_values[p];
+      }
+
+      if (!(pivot > T{})) return false;
+
+      m_indices.push_back(i);
+      m_values.push_back(std::sqrt(pivot));
+      m_offsets.push_back(m_indices.size());
+    }
+
+    return true;
+  }
+
+public:
+  incomplete_cholesky_preconditioner(const sparse_matrix<T> &mat) {
+    const auto csr = mat.to_csr();
+    for (T shift{}; !factorize(csr, shift);) {
+      shift = (shift == T{} ? T{1e-3} : 2 * shift);
+    }
+  }
+
+  void apply(const std::vector<T> &r, std::vector<T> &z) const {
+    const auto n = r.size();
+    z = r;
+
+    for (size_type i = 0; i < n; ++i) {
+      const auto diag_pos = m_offsets[i + 1] - 1;
+      for (auto p = m_offsets[i]; p < diag_pos; ++p) {
+        z[i] -= m_values[p] * z[m_indices[p]];
+      }
+      z[i] /= m_values[diag_pos];
+    }
+
+    for (size_type i = n; i-- > 0;) {
+      const auto diag_pos = m_offsets[i + 1] - 1;
+      z[i] /= m_values[diag_pos];
+      for (auto p = m_offsets[i]; p < diag_pos; ++p) {
+        z[m_indices[p]] -= m_values[p] * z[i];
+      }
+    }
+  }
+};
+
+} // namespace detail
+
+template <std::floating_point T> class conjugate_gradient_solver final {
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using matrix_type = sparse_matrix<value_type>;
+  using options = conjugate_gradient_options<value_type>;
+
+private:
+  matrix_type m_matrix;
+  options     m_options;
+
+  std::optional<detail::jacobi_preconditioner<value_type>>             m_jacobi;
+  std::optional<detail::incomplete_cholesky_preconditioner<value_type>> m_cholesky;
+  std::optional<algebraic_multigrid<value_type>>                        m_multigrid;
+
+  size_type  m_iterations = 0;
+  value_type m_residual = 0;
+
+  void precondition(const std::vector<value_type> &r, std::vector<value_type> &z) const {
+    if (m_jacobi) m_jacobi->apply(r, z);
+    else if (m_cholesky) m_cholesky->apply(r, z);
+    else if (m_multigrid) m_multigrid->apply(r, z);
+    else z = r;
+  }
+
+public:
+  conjugate_gradient_solver(matrix_type mat, const options &opts = options{})
+      : m_matrix{mat.to_csr()}, m_options{opts} {
+    if (!m_matrix.square()) throw std::runtime_error("Mismatched matrix size for conjugate gradient");
+    if (m_options.preconditioner == preconditioner_kind::jacobi) m_jacobi.emplace(m_matrix);
+    if (m_options.preconditioner == preconditioner_kind::incomplete_cholesky) m_cholesky.emplace(m_matrix);
+    if (m_options.preconditioner == preconditioner_kind::algebraic_multigrid)
+      m_multigrid.emplace(m_matrix, m_options.multigrid);
+  }
+
+  // Number of iterations and relative residual of the last call to solve().
+  size_type  iterations() const { return m_iterations; }
+  value_type relative_residual() const { return m_residual; }
+
+  // Returns std::nullopt if the iteration cap is hit or the method breaks down, which happens when the matrix is not
+  // positive definite.
+  std::optional<std::vector<value_type>> solve(const std::vector<value_type> &rhs) {
+    const auto n = m_matrix.rows();
+    if (rhs.size() != n) throw std::runtime_error("Mismatched right hand side size");
+
+    const auto max_iterations = (m_options.max_iterations ? m_options.max_iterations : std::max(n, size_type{1}));
+    const auto rhs_norm = std::sqrt(detail::dot(rhs, rhs));
+
+    std::vector<value_type> x(n, value_type{}), r = rhs, z(n), p(n), ap(n);
+    m_iterations = 0;
+    m_residual = 0;
+
+    if (rhs_norm == value_type{}) return x;
+
+    precondition(r, z);
+    p = z;
+    auto rz = detail::dot(r, z);
+
+    while (m_iterations < max_iterations) {
+      ap = m_matrix * p;
+      const auto pap = detail::dot(p, ap);
+      if (!(pap > value_type{})) return std::nullopt;
+
+      const auto alpha = rz / pap;
+      for (size_type i = 0; i < n; ++i) {
+        x[i] += alpha * p[i];
+        r[i] -= alpha * ap[i];
+      }
+
+      ++m_iterations;
+      m_residual = std::sqrt(detail::dot(r, r)) / rhs_norm;
+      if (m_residual <= m_options.tolerance) return x;
+
+      precondition(r, z);
+      const auto rz_next = detail::dot(r, z);
+      const auto beta = rz_next / rz;
+      rz = rz_next;
+
+      for (size_type i = 0; i < n; ++i) {
+        p[i] = z[i] + beta * p[i];
+      }
+    }
+
+    return std::nullopt;
+  }
+};
+
+} // namespace throttle::linmath
@@ -12,6 +12,8 @@
 
 #include "datastructures/vector.hpp"
 #include "equal.hpp"
+#include "gemm.hpp"
+#include "simd_kernels.hpp"
 #include "utility.hpp"
 
 #include <algorithm>
@@ -139,19 +141,18 @@ public:
 
   contiguous_matrix &operator+=(const contiguous_matrix &other) {
     if ((m_cols != other.m_cols) || (m_rows != other.m_rows)) throw std::runtime_error("Mismatched matrix sizes");
-    std::transform(m_buffer.begin(), m_buffer.end(), other.m_buffer.begin(), m_buffer.begin(), std::plus<value_type>{});
+    kernels::add(m_buffer.size(), other.data(), data());
     return *this;
   }
 
   contiguous_matrix &operator-=(const contiguous_matrix &other) {
     if ((m_cols != other.m_cols) || (m_rows != other.m_rows)) throw std::runtime_error("Mismatched matrix sizes");
-    std::transform(m_buffer.begin(), m_buffer.end(), other.m_buffer.begin(), m_buffer.begin(),
-                   std::minus<value_type>{});
+    kernels::sub(m_buffer.size(), other.data(), data());
     return *this;
   }
 
   contiguous_matrix &operator*=(value_type rhs) {
-    std::transform(m_buffer.begin(), m_buffer.end(), m_buffer.begin(), [rhs](auto &&val) { return val * rhs; });
+    kernels::scale(m_buffer.size(), rhs, data());
     return *this;
   }
 
@@ -164,14 +165,12 @@ public:
   bool equal(const contiguous_matrix &other,
              const value_type        &precision = default_precision<value_type>::m_prec) const {
     if ((rows() != other.rows()) || (cols() != other.cols())) return false;
-    for (size_type i = 0; i < rows(); i++) {
-      const auto first_row = (*this)[i];
-      const auto second_row = other[i];
-      if (!std::equal(first_row.begin(), first_row.end(), second_row.begin(),
-                      [precision](auto first, auto second) { return is_roughly_equal(first, second, precision); }))
-        return false;
-    }
-    return true;
+    return kernels::roughly_equal(m_buffer.size(), data(), other.data(), precision);
+  }
+
+private:
+  auto row_accessor() const {
+    return [data = data(), cols = m_cols](size_type i) { return data + i * cols; };
   }
 
 public:
@@ -200,15 +199,19 @@ public:
   contiguous_matrix &operator*=(const contiguous_matrix &rhs) {
     if (m_cols != rhs.m_rows) throw std::runtime_error("Mismatched matrix sizes");
 
-    contiguous_matrix res{m_rows, rhs.m_cols}, t_rhs = rhs;
-    t_rhs.transpose();
+    contiguous_matrix res{m_rows, rhs.m_cols};
+    kernels::gemm(m_rows, rhs.m_cols, m_cols, row_accessor(), rhs.row_accessor(), res.data(), res.m_cols);
 
-    for (size_type i = 0; i < m_rows; i++) {
-      for (size_type j = 0; j < t_rhs.m_rows; j++) {
-        const auto range_first = (*this)[i], range_second = t_rhs[j];
-        res[i][j] = std::inner_product(range_first.begin(), range_first.end(), range_second.begin(), value_type{});
-      }
-    }
+    std::swap(*this, res);
+    return *this;
+  }
+
+  // Same as operator*=, with the row blocks of the product computed on the pool.
+  contiguous_matrix &multiply(const contiguous_matrix &rhs, concurrency::thread_pool &pool) {
+    if (m_cols != rhs.m_rows) throw std::runtime_error("Mismatched matrix sizes");
+
+    contiguous_matrix res{m_rows, rhs.m_cols};
+    kernels::gemm(m_rows, rhs.m_cols, m_cols, row_accessor(), rhs.row_accessor(), res.data(), res.m_cols, pool);
 
     std::swap(*this, res);
     return *this;
@@ -0,0 +1,336 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Packed, cache-blocked matrix product C += A * B.
+ * The loop nest is the usual one from GotoBLAS: B is cut into kc x nc slabs that stay in L3 and A into mc x kc blocks
+ * that stay in L2. Both get copied ("packed") into panels of nr columns and mr rows, so the micro-kernel streams
+ * through contiguous memory and keeps an mr x nr tile of C in registers for the whole depth of the slab. Edges are
+ * zero padded in the packed copies, which lets the kernel always run on full tiles.
+ *
+ * Rows of A and B are fetched through accessors returning a pointer to the start of a row, so matrices that permute
+ * their rows can be multiplied without gathering them first. Packing never transposes B into a temporary matrix.
+ *
+ * For float and double the micro-kernel is picked from the active SIMD level of simd_kernels.hpp; other types use the
+ * portable template kernel. With a thread pool the mc blocks of each slab are computed in parallel, each task packing
+ * its own block of A.
+ */
+
+#pragma once
+
+#include "concurrency/task_graph.hpp"
+#include "concurrency/thread_pool.hpp"
+#include "simd_kernels.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace throttle::linmath::kernels {
+
+namespace detail {
+
+struct gemm_shape {
+  std::size_t mr, nr;
+};
+
+// Block sizes in elements. mc and nc are multiples of every mr and nr below.
+constexpr std::size_t gemm_kc = 256;
+constexpr std::size_t gemm_mc = 128;
+constexpr std::size_t gemm_nc = 4096;
+
+// Portable micro-kernel: c[mr x nr] += a_panel * b_panel over a depth of kc.
+template <typename T, std::size_t mr, std::size_t nr>
+void gemm_kernel(std::size_t kc, const T *a, const T *b, T *c, std::size_t ldc) {
+  T acc[mr][nr] = {};
+
+  for (std::size_t p = 0; p < kc; ++p, a += mr, b += nr) {
+    for (std::size_t i = 0; i < mr; ++i) {
+      for (std::size_t j = 0; j < nr; ++j) {
+        acc[i][j] = acc[i][j] + a[i] * b[j];
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < mr; ++i) {
+    for (std::size_t j = 0; j < nr; ++j) {
+      c[i * ldc + j] = c[i * ldc + j] + acc[i][j];
+    }
+  }
+}
+
+#ifdef THROTTLE_HAS_X86_SIMD
+
+#define THROTTLE_AVX2   __attribute__((target("avx2,fma")))
+#define THROTTLE_AVX512 __attribute__((target("avx512f")))
+
+// The accumulator arrays are fully unrolled, so every element lives in its own register.
+
+THROTTLE_AVX2 inline void gemm_kernel_avx2(std::size_t kc, const double *a, const double *b, double *c,
+                                           std::size_t ldc) {
+  __m256d acc[4][2];
+#pragma GCC unroll 4
+  for (int i = 0; i < 4; ++i) {
+    acc[i][0] = acc[i][1] = _mm256_setzero_pd();
+  }
+
+  for (std::size_t p = 0; p < kc; ++p, a += 4, b += 8) {
+    const auto b0 = _mm256_loadu_pd(b), b1 = _mm256_loadu_pd(b + 4);
+#pragma GCC unroll 4
+    for (int i = 0; i < 4; ++i) {
+      const auto ai = _mm256_broadcast_sd(a + i);
+      acc[i][0] = _mm256_fmadd_pd(ai, b0, acc[i][0]);
+      acc[i][1] = _mm256_fmadd_pd(ai, b1, acc[i][1]);
+    }
+  }
+
+#pragma GCC unroll 4
+  for (int i = 0; i < 4; ++i) {
+    _mm256_storeu_pd(c + i * ldc, _mm256_add_pd(_mm256_loadu_pd(c + i * ldc), acc[i][0]));
+    _mm256_storeu_pd(c + i * ldc + 4, _mm256_add_pd(_mm256_loadu_pd(c + i * ldc + 4), acc[i][1]));
+  }
+}
+
+THROTTLE_AVX2 inline void gemm_kernel_avx2(std::size_t kc, const float *a, const float *b, float *c,
+                                           std::size_t ldc) {
+  __m256 acc[4][2];
+#pragma GCC unroll 4
+  for (int i = 0; i < 4; ++i) {
+    acc[i][0] = acc[i][1] = _mm256_setzero_ps();
+  }
+
+  for (std::size_t p = 0; p < kc; ++p, a += 4, b += 16) {
+    const auto b0 = _mm256_loadu_ps(b), b1 = _mm256_loadu_ps(b + 8);
+#pragma GCC unroll 4
+    for (int i = 0; i < 4; ++i) {
+      const auto ai = _mm256_broadcast_ss(a + i);
+      acc[i][0] = _mm256_fmadd_ps(ai, b0, acc[i][0]);
+      acc[i][1] = _mm256_fmadd_ps(ai, b1, acc[i][1]);
+    }
+  }
+
+#pragma GCC unroll 4
+  for (int i = 0; i < 4; ++i) {
+    _mm256_storeu_ps(c + i * ldc, _mm256_add_ps(_mm256_loadu_ps(c + i * ldc), acc[i][0]));
+    _mm256_storeu_ps(c + i * ldc + 8, _mm256_add_ps(_mm256_loadu_ps(c + i * ldc + 8), acc[i][1]));
+  }
+}
+
+THROTTLE_AVX512 inline void gemm_kernel_avx512(std::size_t kc, const double *a, const double *b, double *c,
+                                               std::size_t ldc) {
+  __m512d acc[8][2];
+#pragma GCC unroll 8
+  for (int i = 0; i < 8; ++i) {
+    acc[i][0] = acc[i][1] = _mm512_setzero_pd();
+  }
+
+  for (std::size_t p = 0; p < kc; ++p, a += 8, b += 16) {
+    const auto b0 = _mm512_loadu_pd(b), b1 = _mm512_loadu_pd(b + 8);
+#pragma GCC unroll 8
+    for (int i = 0; i < 8; ++i) {
+      const auto ai = _mm512_set1_pd(a[i]);
+      acc[i][0] = _mm512_fmadd_pd(ai, b0, acc[i][0]);
+      acc[i][1] = _mm512_fmadd_pd(ai, b1, acc[i][1]);
+    }
+  }
+
+#pragma GCC unroll 8
+  for (int i = 0; i < 8; ++i) {
+    _mm512_storeu_pd(c + i * ldc, _mm512_add_pd(_mm512_loadu_pd(c + i * ldc), acc[i][0]));
+    _mm512_storeu_pd(c + i * ldc + 8, _mm512_add_pd(_mm512_loadu_pd(c + i * ldc + 8), acc[i][1]));
+  }
+}
+
+THROTTLE_AVX512 inline void gemm_kernel_avx512(std::size_t kc, const float *a, const float *b, float *c,
+                                               std::size_t ldc) {
+  __m512 acc[8][2];
+#pragma GCC unroll 8
+  for (int i = 0; i < 8; ++i) {
+    acc[i][0] = acc[i][1] = _mm512_setzero_ps();
+  }
+
+  for (std::size_t p = 0; p < kc; ++p, a += 8, b += 32) {
+    const auto b0 = _mm512_loadu_ps(b), b1 = _mm512_loadu_ps(b + 16);
+#pragma GCC unroll 8
+    for (int i = 0; i < 8; ++i) {
+      const auto ai = _mm512_set1_ps(a[i]);
+      acc[i][0] = _mm512_fmadd_ps(ai, b0, acc[i][0]);
+      acc[i][1] = _mm512_fmadd_ps(ai, b1, acc[i][1]);
+    }
+  }
+
+#pragma GCC unroll 8
+  for (int i = 0; i < 8; ++i) {
+    _mm512_storeu_ps(c + i * ldc, _mm512_add_ps(_mm512_loadu_ps(c + i * ldc), acc[i][0]));
+    _mm512_storeu_ps(c + i * ldc + 16, _mm512_add_ps(_mm512_loadu_ps(c + i * ldc + 16), acc[i][1]));
+  }
+}
+
+#undef THROTTLE_AVX2
+#undef THROTTLE_AVX512
+
+#endif
+
+// Micro-kernel for T at the active SIMD level. Packing has to use the same shape as the kernel.
+template <typename T> struct gemm_micro_kernel {
+  using kernel_type = void (*)(std::size_t, const T *, const T *, T *, std::size_t);
+
+  gemm_shape  m_shape = {4, 4};
+  kernel_type m_kernel = gemm_kernel<T, 4, 4>;
+
+  gemm_micro_kernel() {
+#ifdef THROTTLE_HAS_X86_SIMD
+    if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+      constexpr std::size_t lanes = 32 / sizeof(T); // Per AVX2 register
+      switch (active_simd_level()) {
+      case simd_level::avx512:
+        m_shape = {8, 4 * lanes};
+        m_kernel = gemm_kernel_avx512;
+        break;
+      case simd_level::avx2:
+        m_shape = {4, 2 * lanes};
+        m_kernel = gemm_kernel_avx2;
+        break;
+      default: break;
+      }
+    }
+#endif
+  }
+};
+
+// Copy rows [i0, i0 + mc) x columns [p0, p0 + kc) of A into panels of mr rows stored column by column.
+template <typename T, typename t_rows>
+void pack_lhs(t_rows lhs_row, std::size_t i0, std::size_t mc, std::size_t p0, std::size_t kc, std::size_t mr,
+              T *packed) {
+  for (std::size_t ir = 0; ir < mc; ir += mr) {
+    const auto rows = std::min(mr, mc - ir);
+    for (std::size_t i = 0; i < mr; ++i) {
+      if (i < rows) {
+        const T *row = lhs_row(i0 + ir + i) + p0;
+        for (std::size_t p = 0; p < kc; ++p) {
+          packed[p * mr + i] = row[p];
+        }
+      } else {
+        for (std::size_t p = 0; p < kc; ++p) {
+          packed[p * mr + i] = T{};
+        }
+      }
+    }
+    packed += mr * kc;
+  }
+}
+
+// Copy rows [p0, p0 + kc) x columns [j0, j0 + nc) of B into panels of nr columns stored row by row.
+template <typename T, typename t_rows>
+void pack_rhs(t_rows rhs_row, std::size_t p0, std::size_t kc, std::size_t j0, std::size_t nc, std::size_t nr,
+              T *packed) {
+  for (std::size_t jr = 0; jr < nc; jr += nr) {
+    const auto cols = std::min(nr, nc - jr);
+    for (std::size_t p = 0; p < kc; ++p) {
+      const T *row = rhs_row(p0 + p) + j0 + jr;
+      std::copy(row, row + cols, packed + p * nr);
+      std::fill(packed + p * nr + cols, packed + (p + 1) * nr, T{});
+    }
+    packed += nr * kc;
+  }
+}
+
+// C[i0:i0+mc, j0:j0+nc] += packed A block * packed B slab.
+template <typename T>
+void gemm_block(const gemm_micro_kernel<T> &kernel, std::size_t mc, std::size_t nc, std::size_t kc, const T *packed_lhs,
+                const T *packed_rhs, T *c, std::size_t ldc) {
+  const auto [mr, nr] = kernel.m_shape;
+  std::vector<T> edge(mr * nr);
+
+  for (std::size_t jr = 0; jr < nc; jr += nr) {
+    const auto cols = std::min(nr, nc - jr);
+    for (std::size_t ir = 0; ir < mc; ir += mr) {
+      const auto rows = std::min(mr, mc - ir);
+      const auto a = packed_lhs + ir * kc, b = packed_rhs + jr * kc;
+      const auto tile = c + ir * ldc + jr;
+
+      if (rows == mr && cols == nr) {
+        kernel.m_kernel(kc, a, b, tile, ldc);
+        continue;
+      }
+
+      // Partial tile on the bottom or right edge. Compute the padded tile aside and add only the valid part.
+      std::fill(edge.begin(), edge.end(), T{});
+      kernel.m_kernel(kc, a, b, edge.data(), nr);
+      for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < cols; ++j) {
+          tile[i * ldc + j] = tile[i * ldc + j] + edge[i * nr + j];
+        }
+      }
+    }
+  }
+}
+
+template <typename T, typename t_lhs, typename t_rhs>
+void gemm(std::size_t m, std::size_t n, std::size_t k, t_lhs lhs_row, t_rhs rhs_row, T *c, std::size_t ldc,
+          concurrency::thread_pool *pool) {
+  const gemm_micro_kernel<T> kernel;
+  const auto [mr, nr] = kernel.m_shape;
+  const auto blocks = (m + gemm_mc - 1) / gemm_mc;
+  const bool parallel = pool && pool->size() > 1 && blocks > 1;
+
+  std::vector<T> packed_rhs, packed_lhs;
+
+  for (std::size_t j0 = 0; j0 < n; j0 += gemm_nc) {
+    const auto nc = std::min(gemm_nc, n - j0);
+
+    for (std::size_t p0 = 0; p0 < k; p0 += gemm_kc) {
+      const auto kc = std::min(gemm_kc, k - p0);
+      packed_rhs.resize((nc + nr - 1) / nr * nr * kc);
+      pack_rhs(rhs_row, p0, kc, j0, nc, nr, packed_rhs.data());
+
+      const auto block = [&, j0, p0, nc, kc](std::size_t i0, std::vector<T> &lhs) {
+        const auto mc = std::min(gemm_mc, m - i0);
+        lhs.resize((mc + mr - 1) / mr * mr * kc);
+        pack_lhs(lhs_row, i0, mc, p0, kc, mr, lhs.data());
+        gemm_block(kernel, mc, nc, kc, lhs.data(), packed_rhs.data(), c + i0 * ldc + j0, ldc);
+      };
+
+      if (!parallel) {
+        for (std::size_t i0 = 0; i0 < m; i0 += gemm_mc) {
+          block(i0, packed_lhs);
+        }
+        continue;
+      }
+
+      // Row blocks write disjoint parts of C, so they're independent tasks.
+      concurrency::task_graph graph;
+      for (std::size_t i0 = 0; i0 < m; i0 += gemm_mc) {
+        graph.add([&block, i0] {
+          std::vector<T> lhs;
+          block(i0, lhs);
+        });
+      }
+      graph.run(*pool);
+    }
+  }
+}
+
+} // namespace detail
+
+// C += A * B for an (m x k) A and a (k x n) B. lhs_row(i) and rhs_row(p) return pointers to the rows of A and B; C is
+// row-major with leading dimension ldc.
+template <typename T, typename t_lhs, typename t_rhs>
+void gemm(std::size_t m, std::size_t n, std::size_t k, t_lhs lhs_row, t_rhs rhs_row, T *c, std::size_t ldc) {
+  detail::gemm(m, n, k, lhs_row, rhs_row, c, ldc, nullptr);
+}
+
+template <typename T, typename t_lhs, typename t_rhs>
+void gemm(std::size_t m, std::size_t n, std::size_t k, t_lhs lhs_row, t_rhs rhs_row, T *c, std::size_t ldc,
+          concurrency::thread_pool &pool) {
+  detail::gemm(m, n, k, lhs_row, rhs_row, c, ldc, &pool);
+}
+
+} // namespace throttle::linmath::kernels
@@ -10,16 +10,45 @@
 
 #pragma once
 
+#include "concurrency/thread_pool.hpp"
 #include "datastructures/vector.hpp"
+#include "linmath/lu_factorization.hpp"
 #include "linmath/matrix.hpp"
+#include "linmath/sparse_lu.hpp"
+#include "linmath/sparse_matrix.hpp"
 
 #include <algorithm>
 #include <concepts>
 #include <initializer_list>
+#include <iterator>
 #include <optional>
+#include <stdexcept>
+#include <vector>
 
 namespace throttle::linmath {
 
+namespace detail {
+// Solve a square system given as an extended matrix [A | b] with Gauss-Jordan elimination.
+template <std::floating_point T> std::optional<matrix<T>> solve_xtnd_matrix(matrix<T> xtnd_matrix) {
+  auto cols = xtnd_matrix.cols();
+  auto rows = xtnd_matrix.rows();
+
+  xtnd_matrix.convert_to_row_echelon();
+
+  matrix<T> res{cols - 1, 1};
+  for (std::size_t i = 0; i < cols - 1; i++) {
+    if (is_roughly_equal(xtnd_matrix[i][i], T{0})) return std::nullopt;
+    res[i][0] = xtnd_matrix[i][cols - 1] / xtnd_matrix[i][i];
+  }
+
+  for (std::size_t i = cols - 1; i < rows; i++) {
+    if (!is_roughly_equal(xtnd_matrix[i][cols - 1], T{0})) return std::nullopt;
+  }
+
+  return res;
+}
+} // namespace detail
+
 template <std::floating_point T> struct linear_equation final {
   using value_type = T;
   using size_type = std::size_t;
@@ -110,25 +139,119 @@ public:
     return (m_matrix = xtnd_matrix);
   }
 
+  contiguous_matrix<value_type> coefficient_matrix() const {
+    const auto n = vars();
+    if (size() != n) throw std::runtime_error("Mismatched system size for LU factorization");
+
+    contiguous_matrix<value_type> coefs{n, n};
+    for (size_type i = 0; i < n; ++i) {
+      std::copy_n(m_equations[i].begin(), m_equations[i].vars(), coefs[i].begin());
+    }
+
+    return coefs;
+  }
+
+  // LU factorization of the coefficient matrix. It can be reused for any number of right hand sides.
+  lu_factorization<value_type> factorize() const { return lu_factorization<value_type>{coefficient_matrix()}; }
+
+  // Same, but large systems are factorized in parallel on the threads of pool.
+  lu_factorization<value_type> factorize(concurrency::thread_pool &pool) const {
+    return lu_factorization<value_type>{coefficient_matrix(), pool};
+  }
+
+  std::vector<value_type> free_coeffs() const {
+    std::vector<value_type> res;
+    res.reserve(size());
+    std::transform(m_equations.begin(), m_equations.end(), std::back_inserter(res),
+                   [](const auto &eq) { return eq.free_coeff(); });
+    return res;
+  }
+
+  // Square systems are solved through an LU factorization, overdetermined ones fall back to Gauss-Jordan elimination on
+  // the extended matrix, which also checks the extra equations for consistency.
   std::optional<matrix<value_type>> solve() const {
-    auto xtnd_matrix = get_xtnd_matrix();
-    auto cols = xtnd_matrix.cols();
-    auto rows = xtnd_matrix.rows();
+    if (size() != vars()) return detail::solve_xtnd_matrix(get_xtnd_matrix());
+    return to_column(factorize().solve(free_coeffs()));
+  }
+
+  std::optional<matrix<value_type>> solve(concurrency::thread_pool &pool) const {
+    if (size() != vars()) return detail::solve_xtnd_matrix(get_xtnd_matrix());
+    return to_column(factorize(pool).solve(free_coeffs()));
+  }
+
+  // Solve for every column of rhs with a single factorization. Column j of the result solves the system with the free
+  // coefficients replaced by column j of rhs. Only square systems are supported.
+  std::optional<contiguous_matrix<value_type>> solve_batch(const contiguous_matrix<value_type> &rhs) const {
+    return factorize().solve_batch(rhs);
+  }
+
+private:
+  std::optional<matrix<value_type>> to_column(const std::optional<std::vector<value_type>> &res) const {
+    if (!res) return std::nullopt;
+    return matrix<value_type>{size(), 1, res.value().begin(), res.value().end()};
+  }
+};
+
+// Square system that is assembled by stamping individual coefficients instead of pushing whole equations. Stamps to
+// the same position are summed, so memory and assembly time grow with the number of nonzeros.
+template <std::floating_point T> class sparse_linear_system final {
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using matrix_type = sparse_matrix<value_type>;
+  using triplet_type = typename matrix_type::triplet_type;
+
+private:
+  size_type                 m_vars = 0;
+  std::vector<triplet_type> m_stamps;
+  std::vector<value_type>   m_free;
+
+public:
+  sparse_linear_system() = default;
+  sparse_linear_system(size_type vars, size_type expected_stamps = 0) : m_vars{vars}, m_free(vars) {
+    m_stamps.reserve(expected_stamps);
+  }
 
-    xtnd_matrix.convert_to_row_echelon();
+  void stamp(size_type row, size_type col, value_type val) { m_stamps.push_back({row, col, val}); }
 
-    matrix<value_type> res{cols - 1, 1};
-    for (size_type i = 0; i < cols - 1; i++) {
-      if (is_roughly_equal(xtnd_matrix[i][i], 0.0)) return std::nullopt;
-      res[i][0] = xtnd_matrix[i][cols - 1] / xtnd_matrix[i][i];
+  value_type       &free_coeff(size_type row) { return m_free[row]; }
+  const value_type &free_coeff(size_type row) const { return m_free[row]; }
+
+  const std::vector<value_type> &free_coeffs() const { return m_free; }
+
+  size_type size() const { return m_vars; }
+  size_type vars() const { return m_vars; }
+
+  matrix_type get_matrix(sparse_format format = sparse_format::csr) const {
+    return matrix_type{m_vars, m_vars, m_stamps.begin(), m_stamps.end(), format};
+  }
+
+  // Dense extended matrix [A | b]. This costs O(n^2) memory and should only be used when the dense path is requested.
+  matrix<value_type> get_xtnd_matrix() const {
+    matrix<value_type> xtnd_matrix{m_vars, m_vars + 1};
+
+    for (const auto &s : m_stamps) {
+      xtnd_matrix[s.row][s.col] += s.value;
     }
 
-    for (size_type i = cols - 1; i < rows; i++) {
-      if (!is_roughly_equal(xtnd_matrix[i][cols - 1], 0.0)) return std::nullopt;
+    for (size_type i = 0; i < m_vars; ++i) {
+      xtnd_matrix[i][m_vars] = m_free[i];
     }
 
-    return res;
+    return xtnd_matrix;
+  }
+
+  std::optional<std::vector<value_type>> solve(const typename sparse_lu<value_type>::options &opts = {}) const {
+    sparse_lu<value_type> lu{get_matrix(sparse_format::csc), opts};
+    return lu.solve(m_free);
+  }
+
+  // One factorization for all columns of rhs, see linear_equation_system::solve_batch.
+  std::optional<contiguous_matrix<value_type>> solve_batch(const contiguous_matrix<value_type>            &rhs,
+                                                           const typename sparse_lu<value_type>::options &opts = {}) const {
+    sparse_lu<value_type> lu{get_matrix(sparse_format::csc), opts};
+    return lu.solve_batch(rhs);
   }
 };
 
-} // namespace throttle::linmath
\ No newline at end of file
+} // namespace throttle::linmath
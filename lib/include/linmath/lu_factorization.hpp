@@ -0,0 +1,323 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Dense LU factorization with partial pivoting, P * A = L * U.
+ * The factorization is computed once and then reused for the determinant and for any number of right hand sides, each
+ * of which costs a forward and a backward substitution. L (with an implicit unit diagonal) and U are packed into a
+ * single row-major contiguous_matrix. The kernel is the right-looking blocked variant: a narrow panel of columns is
+ * factorized first, then the block row to its right is solved against the panel and the trailing submatrix gets a
+ * rank-block_size update. Innermost loops always run along rows, so they stream contiguous memory.
+ *
+ * Given a thread_pool, large matrices are factorized as a task graph over square tiles of the same buffer. Step k has
+ * a panel task for tile column k, one swap + triangular solve task per tile to the right of the diagonal and one
+ * update task per trailing tile. Tasks of different steps overlap as soon as their tiles are ready, so the next panel
+ * can start while the rest of the trailing matrix is still being updated. Row interchanges are confined to the tile
+ * column that owns them, the ones left of the diagonal are applied after the graph has finished.
+ */
+
+#pragma once
+
+#include "concurrency/task_graph.hpp"
+#include "concurrency/thread_pool.hpp"
+#include "contiguous_matrix.hpp"
+#include "equal.hpp"
+#include "simd_kernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace throttle::linmath {
+
+template <std::floating_point T> class lu_factorization final {
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+  static constexpr size_type block_size = 64;
+  static constexpr size_type tile_size = 256;
+  static constexpr size_type max_tiles = 32; // Upper bound on tiles per dimension for the task graph
+
+private:
+  size_type                     m_size = 0;
+  contiguous_matrix<value_type> m_lu;
+  std::vector<size_type>        m_pivots; // Row k was swapped with row m_pivots[k] >= k at step k
+  std::vector<size_type>        m_perm;   // Row k of P * A is row m_perm[k] of A
+  int                           m_sign = 1;
+  bool                          m_singular = false;
+
+  // row[first, last) -= coef * other[first, last)
+  static void axpy_row(value_type *row, const value_type *other, value_type coef, size_type first, size_type last) {
+    if (first < last) kernels::axpy(last - first, -coef, other + first, row + first);
+  }
+
+  value_type       *row(size_type i) { return m_lu.data() + i * m_size; }
+  const value_type *row(size_type i) const { return m_lu.data() + i * m_size; }
+
+  // Apply the row interchanges of steps [k0, k1) to the columns [c0, c1).
+  void apply_pivots(size_type k0, size_type k1, size_type c0, size_type c1) {
+    if (c0 >= c1) return;
+    for (size_type k = k0; k < k1; ++k) {
+      if (m_pivots[k] != k) std::swap_ranges(row(k) + c0, row(k) + c1, row(m_pivots[k]) + c0);
+    }
+  }
+
+  // Unblocked elimination of the panel A[k0:n, k0:k1]. Row interchanges only touch the panel itself.
+  bool factorize_panel(size_type k0, size_type k1) {
+    const auto n = m_size;
+
+    for (size_type k = k0; k < k1; ++k) {
+      size_type pivot_row = k;
+      for (size_type i = k + 1; i < n; ++i) {
+        if (std::abs(row(i)[k]) > std::abs(row(pivot_row)[k])) pivot_row = i;
+      }
+
+      if (is_roughly_equal(row(pivot_row)[k], value_type{})) return false;
+
+      m_pivots[k] = pivot_row;
+      if (pivot_row != k) std::swap_ranges(row(k) + k0, row(k) + k1, row(pivot_row) + k0);
+
+      const auto pivot = row(k)[k];
+      for (size_type i = k + 1; i < n; ++i) {
+        auto *current = row(i);
+        current[k] /= pivot;
+        axpy_row(current, row(k), current[k], k + 1, k1);
+      }
+    }
+
+    return true;
+  }
+
+  // U12 = L11^-1 * P * A12 for the block row [k0, k1) restricted to the columns [c0, c1).
+  void solve_block_row(size_type k0, size_type k1, size_type c0, size_type c1) {
+    apply_pivots(k0, k1, c0, c1);
+    for (size_type k = k0; k < k1; ++k) {
+      for (size_type i = k + 1; i < k1; ++i) {
+        axpy_row(row(i), row(k), row(i)[k], c0, c1);
+      }
+    }
+  }
+
+  // A[r0:r1, c0:c1] -= L[r0:r1, k0:k1] * U[k0:k1, c0:c1], blocked so that the piece of U in use stays in cache.
+  void update_block(size_type k0, size_type k1, size_type r0, size_type r1, size_type c0, size_type c1) {
+    for (size_type j0 = c0; j0 < c1; j0 += tile_size) {
+      const auto j1 = std::min(c1, j0 + tile_size);
+      for (size_type l0 = k0; l0 < k1; l0 += block_size) {
+        const auto l1 = std::min(k1, l0 + block_size);
+        for (size_type i = r0; i < r1; ++i) {
+          auto *current = row(i);
+          for (size_type k = l0; k < l1; ++k) {
+            axpy_row(current, row(k), current[k], j0, j1);
+          }
+        }
+      }
+    }
+  }
+
+  // Blocked factorization of the column slab A[s0:n, s0:s1]. Row interchanges stay inside the slab.
+  bool factorize_slab(size_type s0, size_type s1) {
+    const auto n = m_size;
+
+    for (size_type k0 = s0; k0 < s1; k0 += block_size) {
+      const auto k1 = std::min(s1, k0 + block_size);
+
+      // Step 1. Factorize the panel A[k0:n, k0:k1].
+      if (!factorize_panel(k0, k1)) return false;
+      apply_pivots(k0, k1, s0, k0);
+
+      // Step 2. U12 = L11^-1 * A12.
+      solve_block_row(k0, k1, k1, s1);
+
+      // Step 3. A22 -= L21 * U12.
+      update_block(k0, k1, k1, n, k1, s1);
+    }
+
+    return true;
+  }
+
+  void factorize_tiled(concurrency::thread_pool &pool, size_type tile) {
+    const auto n = m_size;
+    const auto tiles = (n + tile - 1) / tile;
+    const auto first = [tile](size_type t) { return t * tile; };
+    const auto last = [tile, n](size_type t) { return std::min(n, (t + 1) * tile); };
+
+    concurrency::task_graph graph;
+    std::atomic<bool>       singular = false;
+
+    // updates[i][j] is the last task that wrote tile (i, j), or none if it hasn't been touched yet.
+    constexpr auto                      none = std::numeric_limits<size_type>::max();
+    std::vector<std::vector<size_type>> updates(tiles, std::vector<size_type>(tiles, none));
+
+    const auto after_column = [&](size_type task, size_type k, size_type j) {
+      for (size_type i = k; i < tiles; ++i) {
+        if (updates[i][j] != none) graph.depends(task, updates[i][j]);
+      }
+    };
+
+    for (size_type k = 0; k < tiles; ++k) {
+      const auto k0 = first(k), k1 = last(k);
+
+      const auto panel = graph.add([this, &singular, k0, k1] {
+        if (singular.load(std::memory_order_relaxed)) return;
+        if (!factorize_slab(k0, k1)) singular.store(true, std::memory_order_relaxed);
+      });
+      after_column(panel, k, k);
+
+      for (size_type j = k + 1; j < tiles; ++j) {
+        const auto j0 = first(j), j1 = last(j);
+
+        const auto trsm = graph.add([this, &singular, k0, k1, j0, j1] {
+          if (!singular.load(std::memory_order_relaxed)) solve_block_row(k0, k1, j0, j1);
+        });
+        graph.depends(trsm, panel);
+        after_column(trsm, k, j);
+
+        for (size_type i = k + 1; i < tiles; ++i) {
+          const auto i0 = first(i), i1 = last(i);
+          const auto gemm = graph.add([this, &singular, k0, k1, i0, i1, j0, j1] {
+            if (!singular.load(std::memory_order_relaxed)) update_block(k0, k1, i0, i1, j0, j1);
+          });
+          graph.depends(gemm, trsm);
+          updates[i][j] = gemm;
+        }
+      }
+    }
+
+    graph.run(pool);
+    if ((m_singular = singular.load())) return;
+
+    for (size_type k = 1; k < tiles; ++k) {
+      apply_pivots(first(k), last(k), 0, first(k));
+    }
+  }
+
+  void finish_permutation() {
+    m_perm.resize(m_size);
+    std::iota(m_perm.begin(), m_perm.end(), size_type{0});
+    for (size_type k = 0; k < m_size; ++k) {
+      if (m_pivots[k] == k) continue;
+      std::swap(m_perm[k], m_perm[m_pivots[k]]);
+      m_sign = -m_sign;
+    }
+  }
+
+  template <typename t_matrix> void copy_from(const t_matrix &mat) {
+    if (mat.rows() != mat.cols()) throw std::runtime_error("Mismatched matrix size for LU factorization");
+
+    for (size_type i = 0; i < m_size; ++i) {
+      const auto src = mat[i];
+      std::copy(src.begin(), src.end(), row(i));
+    }
+
+    m_pivots.resize(m_size);
+    std::iota(m_pivots.begin(), m_pivots.end(), size_type{0});
+  }
+
+public:
+  // Any square matrix type with rows(), cols() and two level operator[] will do.
+  template <typename t_matrix> lu_factorization(const t_matrix &mat) : m_size{mat.rows()}, m_lu{m_size, m_size} {
+    copy_from(mat);
+    m_singular = !factorize_slab(0, m_size);
+    finish_permutation();
+  }
+
+  // Same factorization, but matrices of more than two tiles are factorized by the tasks of pool.
+  template <typename t_matrix>
+  lu_factorization(const t_matrix &mat, concurrency::thread_pool &pool) : m_size{mat.rows()}, m_lu{m_size, m_size} {
+    copy_from(mat);
+
+    const auto tile = std::max(tile_size, (m_size / max_tiles + block_size - 1) / block_size * block_size);
+    if (pool.size() > 1 && m_size > 2 * tile) factorize_tiled(pool, tile);
+    else m_singular = !factorize_slab(0, m_size);
+
+    finish_permutation();
+  }
+
+  size_type size() const { return m_size; }
+  bool      singular() const { return m_singular; }
+
+  const contiguous_matrix<value_type> &packed() const { return m_lu; }
+  const std::vector<size_type>        &permutation() const { return m_perm; }
+
+  value_type determinant() const {
+    if (m_singular) return value_type{};
+
+    value_type val = m_sign;
+    for (size_type i = 0; i < m_size; ++i) {
+      val *= m_lu[i][i];
+    }
+
+    return val;
+  }
+
+  std::optional<std::vector<value_type>> solve(const std::vector<value_type> &rhs) const {
+    if (m_singular) return std::nullopt;
+    if (rhs.size() != m_size) throw std::runtime_error("Mismatched right hand side size");
+
+    std::vector<value_type> x(m_size);
+    for (size_type i = 0; i < m_size; ++i) {
+      x[i] = rhs[m_perm[i]];
+    }
+
+    for (size_type i = 0; i < m_size; ++i) {
+      const auto *lu_row = row(i);
+      x[i] -= kernels::dot(i, lu_row, x.data());
+    }
+
+    for (size_type i = m_size; i-- > 0;) {
+      const auto *lu_row = row(i);
+      x[i] -= kernels::dot(m_size - i - 1, lu_row + i + 1, x.data() + i + 1);
+      x[i] /= lu_row[i];
+    }
+
+    return x;
+  }
+
+  // Solve A * X = B for every column of B at once. Substitutions are done with whole rows of X, so the factors are
+  // read once per batch instead of once per right hand side.
+  std::optional<contiguous_matrix<value_type>> solve_batch(const contiguous_matrix<value_type> &rhs) const {
+    if (m_singular) return std::nullopt;
+    if (rhs.rows() != m_size) throw std::runtime_error("Mismatched right hand side size");
+
+    const auto                    m = rhs.cols();
+    contiguous_matrix<value_type> x{m_size, m};
+    const auto                    x_row = [&x, m](size_type i) { return x.data() + i * m; };
+
+    for (size_type i = 0; i < m_size; ++i) {
+      std::copy_n(rhs.data() + m_perm[i] * m, m, x_row(i));
+    }
+
+    for (size_type i = 0; i < m_size; ++i) {
+      const auto *lu_row = row(i);
+      for (size_type k = 0; k < i; ++k) {
+        kernels::axpy(m, -lu_row[k], x_row(k), x_row(i));
+      }
+    }
+
+    for (size_type i = m_size; i-- > 0;) {
+      const auto *lu_row = row(i);
+      for (size_type k = i + 1; k < m_size; ++k) {
+        kernels::axpy(m, -lu_row[k], x_row(k), x_row(i));
+      }
+      kernels::scale(m, value_type{1} / lu_row[i], x_row(i));
+    }
+
+    return x;
+  }
+};
+
+} // namespace throttle::linmath
@@ -12,6 +12,9 @@
 
 #include "contiguous_matrix.hpp"
 #include "equal.hpp"
+#include "gemm.hpp"
+#include "lu_factorization.hpp"
+#include "simd_kernels.hpp"
 #include "utility.hpp"
 
 #include <algorithm>
@@ -147,11 +150,7 @@ public:
   bool equal(const matrix &other, const value_type &precision = default_precision<value_type>::m_prec) const {
     if ((rows() != other.rows()) || (cols() != other.cols())) return false;
     for (size_type i = 0; i < m_rows_vec.size(); i++) {
-      const auto first_row = (*this)[i];
-      const auto second_row = other[i];
-      if (!std::equal(first_row.begin(), first_row.end(), second_row.begin(),
-                      [&precision](auto first, auto second) { return is_roughly_equal(first, second, precision); }))
-        return false;
+      if (!kernels::roughly_equal(cols(), row_pointer(i), other.row_pointer(i), precision)) return false;
     }
     return true;
   }
@@ -209,13 +208,8 @@ public:
 
       for (size_type to_elim_row = 0; to_elim_row < rows(); to_elim_row++) {
         if (i == to_elim_row) continue;
-
-        auto first_row = mat[to_elim_row];
-        auto second_row = mat[i];
-
         auto coef = mat[to_elim_row][i] / pivot_elem;
-        std::transform(first_row.begin(), first_row.end(), second_row.begin(), first_row.begin(),
-                       [coef](value_type left, value_type right) { return left - coef * right; });
+        kernels::axpy(cols(), -coef, row_pointer(i), row_pointer(to_elim_row));
       }
     }
 
@@ -253,17 +247,7 @@ public:
 
   value_type determinant() const requires std::is_floating_point_v<value_type> {
     if (!square()) throw std::runtime_error("Mismatched matrix size for determinant");
-
-    matrix tmp{*this};
-    auto   res = tmp.convert_to_row_echelon();
-    if (!res) return value_type{};
-
-    value_type val = res;
-    for (size_type i = 0; i < rows(); i++) {
-      val *= tmp[i][i];
-    }
-
-    return val;
+    return lu_factorization<value_type>{*this}.determinant();
   }
 
   matrix &operator*=(value_type rhs) {
@@ -279,10 +263,7 @@ public:
   matrix &operator+=(const matrix &other) {
     if (rows() != other.rows() || cols() != other.cols()) throw std::runtime_error("Mismatched matrix sizes");
     for (size_type i = 0; i < rows(); ++i) {
-      auto row_first = (*this)[i];
-      auto row_second = other[i];
-      std::transform(row_first.begin(), row_first.end(), row_second.begin(), row_first.begin(),
-                     std::plus<value_type>{});
+      kernels::add(cols(), other.row_pointer(i), row_pointer(i));
     }
     return *this;
   }
@@ -290,10 +271,7 @@ public:
   matrix &operator-=(const matrix &other) {
     if (rows() != other.rows() || cols() != other.cols()) throw std::runtime_error("Mismatched matrix sizes");
     for (size_type i = 0; i < rows(); ++i) {
-      auto row_first = (*this)[i];
-      auto row_second = other[i];
-      std::transform(row_first.begin(), row_first.end(), row_second.begin(), row_first.begin(),
-                     std::minus<value_type>{});
+      kernels::sub(cols(), other.row_pointer(i), row_pointer(i));
     }
     return *this;
   }
@@ -301,19 +279,28 @@ public:
   matrix &operator*=(const matrix &rhs) {
     if (cols() != rhs.rows()) throw std::runtime_error("Mismatched matrix sizes");
 
-    matrix res{rows(), rhs.cols()}, t_rhs = rhs;
-    t_rhs.transpose();
+    contiguous_matrix<T> res{rows(), rhs.cols()};
+    kernels::gemm(rows(), rhs.cols(), cols(), row_accessor(), rhs.row_accessor(), res.data(), res.cols());
 
-    for (size_type i = 0; i < rows(); i++) {
-      for (size_type j = 0; j < t_rhs.rows(); j++) {
-        const auto range_first = (*this)[i], range_second = t_rhs[j];
-        res[i][j] = std::inner_product(range_first.begin(), range_first.end(), range_second.begin(), value_type{});
-      }
-    }
+    *this = matrix{std::move(res)};
+    return *this;
+  }
+
+  matrix &multiply(const matrix &rhs, concurrency::thread_pool &pool) {
+    if (cols() != rhs.rows()) throw std::runtime_error("Mismatched matrix sizes");
 
-    std::swap(*this, res);
+    contiguous_matrix<T> res{rows(), rhs.cols()};
+    kernels::gemm(rows(), rhs.cols(), cols(), row_accessor(), rhs.row_accessor(), res.data(), res.cols(), pool);
+
+    *this = matrix{std::move(res)};
     return *this;
   }
+
+private:
+  // Rows may be permuted, so the product reads them through row_pointer() instead of assuming a fixed stride.
+  auto row_accessor() const {
+    return [this](size_type i) { return row_pointer(i); };
+  }
 };
 
 // clang-format off
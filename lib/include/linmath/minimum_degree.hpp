@@ -0,0 +1,192 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Fill-reducing ordering for sparse factorizations.
+ * This is a compact version of the approximate minimum degree (AMD) algorithm on the pattern of A + A^T. Elimination
+ * is simulated on a quotient graph: an eliminated pivot turns into an "element" that stands for the clique it would
+ * have created, so the graph never grows beyond its initial size. Degrees are the usual AMD upper bound
+ *
+ *   d(i) = |A_i| + |L_p \ i| + sum over other elements e of |L_e \ L_p|,
+ *
+ * and elements that become subsets of the new pivot element are absorbed. Supervariable detection is not done.
+ */
+
+#pragma once
+
+#include "sparse_matrix.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace throttle::linmath {
+
+namespace detail {
+class minimum_degree_ordering {
+public:
+  using size_type = std::size_t;
+
+private:
+  static constexpr size_type none = std::numeric_limits<size_type>::max();
+
+  enum class node_status { variable, element, absorbed };
+
+  size_type                           m_size;
+  std::vector<std::vector<size_type>> m_vars;  // Adjacent uneliminated variables
+  std::vector<std::vector<size_type>> m_elems; // Adjacent elements for variables, the clique for elements
+  std::vector<node_status>            m_status;
+
+  // Degree buckets as intrusive doubly linked lists.
+  std::vector<size_type> m_degree, m_head, m_next, m_prev;
+
+  void bucket_insert(size_type i, size_type degree) {
+    m_degree[i] = degree;
+    m_prev[i] = none;
+    m_next[i] = m_head[degree];
+    if (m_head[degree] != none) m_prev[m_head[degree]] = i;
+    m_head[degree] = i;
+  }
+
+  void bucket_remove(size_type i) {
+    if (m_prev[i] != none) m_next[m_prev[i]] = m_next[i];
+    else m_head[m_degree[i]] = m_next[i];
+    if (m_next[i] != none) m_prev[m_next[i]] = m_prev[i];
+  }
+
+  bool is_variable(size_type i) const { return m_status[i] == node_status::variable; }
+  bool is_element(size_type i) const { return m_status[i] == node_status::element; }
+
+  void absorb(size_type e) {
+    m_status[e] = node_status::absorbed;
+    std::vector<size_type>{}.swap(m_elems[e]);
+  }
+
+public:
+  template <typename T>
+  minimum_degree_ordering(const sparse_matrix<T> &mat)
+      : m_size{mat.rows()}, m_vars(m_size), m_elems(m_size), m_status(m_size, node_status::variable),
+        m_degree(m_size, 0), m_head(m_size + 1, none), m_next(m_size, none), m_prev(m_size, none) {
+    const auto &offsets = mat.offsets();
+    const auto &indices = mat.indices();
+
+    for (size_type i = 0; i < m_size; ++i) {
+      for (size_type k = offsets[i]; k < offsets[i + 1]; ++k) {
+        const auto j = indices[k];
+        if (i == j) continue;
+        m_vars[i].push_back(j);
+        m_vars[j].push_back(i);
+      }
+    }
+
+    for (size_type i = 0; i < m_size; ++i) {
+      auto &adj = m_vars[i];
+      std::sort(adj.begin(), adj.end());
+      adj.erase(std::unique(adj.begin(), adj.end()), adj.end());
+      bucket_insert(i, adj.size());
+    }
+  }
+
+  std::vector<size_type> operator()() {
+    std::vector<size_type> order;
+    order.reserve(m_size);
+
+    std::vector<size_type> mark(m_size, none), w_stamp(m_size, none), w(m_size, 0);
+    size_type              min_degree = 0;
+
+    for (size_type k = 0; k < m_size; ++k) {
+      while (m_head[min_degree] == none) {
+        ++min_degree;
+      }
+
+      const auto pivot = m_head[min_degree];
+      bucket_remove(pivot);
+      order.push_back(pivot);
+      m_status[pivot] = node_status::element;
+      mark[pivot] = k;
+
+      // Step 1. Construct the new element L_p from adjacent variables and the cliques of all adjacent elements, which
+      // are absorbed into it.
+      std::vector<size_type> pivot_elem;
+      for (const auto j : m_vars[pivot]) {
+        if (!is_variable(j) || mark[j] == k) continue;
+        mark[j] = k;
+        pivot_elem.push_back(j);
+      }
+
+      for (const auto e : m_elems[pivot]) {
+        if (!is_element(e)) continue;
+        for (const auto j : m_elems[e]) {
+          if (!is_variable(j) || mark[j] == k) continue;
+          mark[j] = k;
+          pivot_elem.push_back(j);
+        }
+        absorb(e);
+      }
+
+      std::vector<size_type>{}.swap(m_vars[pivot]);
+      m_elems[pivot] = pivot_elem;
+
+      // Step 2. Compute |L_e \ L_p| for every element adjacent to L_p.
+      for (const auto i : pivot_elem) {
+        bucket_remove(i);
+        for (const auto e : m_elems[i]) {
+          if (!is_element(e) || e == pivot) continue;
+          if (w_stamp[e] != k) {
+            w_stamp[e] = k;
+            w[e] = m_elems[e].size();
+          }
+          --w[e];
+        }
+      }
+
+      // Step 3. Prune adjacency lists and recompute approximate degrees.
+      const auto remaining = m_size - k - 1;
+      for (const auto i : pivot_elem) {
+        size_type external = 0;
+
+        auto &elems = m_elems[i];
+        auto  elem_end = std::remove_if(elems.begin(), elems.end(), [&](size_type e) {
+          if (!is_element(e) || e == pivot) return true;
+          if (w[e] == 0) { // Aggressive absorption: L_e is a subset of L_p.
+            absorb(e);
+            return true;
+          }
+          external += w[e];
+          return false;
+        });
+        elems.erase(elem_end, elems.end());
+        elems.push_back(pivot);
+
+        auto &vars = m_vars[i];
+        vars.erase(std::remove_if(vars.begin(), vars.end(),
+                                  [&](size_type j) { return !is_variable(j) || mark[j] == k || j == i; }),
+                   vars.end());
+
+        const auto degree = std::min(remaining - 1, vars.size() + pivot_elem.size() - 1 + external);
+        bucket_insert(i, degree);
+        min_degree = std::min(min_degree, degree);
+      }
+    }
+
+    return order;
+  }
+};
+} // namespace detail
+
+// Returns a permutation (order[k] is the k-th column to eliminate) that reduces fill in a factorization of mat. Only
+// the pattern of the square matrix is used, so CSR and CSC inputs give the same result.
+template <typename T> std::vector<std::size_t> approximate_minimum_degree(const sparse_matrix<T> &mat) {
+  if (!mat.square()) throw std::runtime_error("Mismatched matrix size for ordering");
+  return detail::minimum_degree_ordering{mat}();
+}
+
+} // namespace throttle::linmath
@@ -0,0 +1,501 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Vectorized BLAS-1 style kernels used by the dense matrices.
+ * Every kernel has a scalar template that works for any ring and explicitly vectorized overloads for float and double
+ * built for SSE2, AVX2 + FMA and AVX-512F. The widest instruction set supported by the CPU is detected once with CPUID
+ * and can be lowered at runtime with set_simd_level(), which is what the benchmark does to compare code paths. On
+ * compilers or targets without x86 intrinsics only the scalar code is built.
+ *
+ * axpy(n, a, x, y):                 y[i] += a * x[i]
+ * add(n, x, y), sub(n, x, y):       y[i] += x[i], y[i] -= x[i]
+ * scale(n, a, x):                   x[i] *= a
+ * dot(n, x, y):                     sum of x[i] * y[i]
+ * roughly_equal(n, x, y, precision): is_roughly_equal(x[i], y[i], precision) for all i
+ */
+
+#pragma once
+
+#include "equal.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define THROTTLE_HAS_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace throttle::linmath::kernels {
+
+enum class simd_level { scalar, sse2, avx2, avx512 };
+
+inline const char *simd_level_name(simd_level level) {
+  switch (level) {
+  case simd_level::sse2: return "sse2";
+  case simd_level::avx2: return "avx2+fma";
+  case simd_level::avx512: return "avx512f";
+  default: return "scalar";
+  }
+}
+
+inline simd_level detect_simd_level() {
+#ifdef THROTTLE_HAS_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return simd_level::avx512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return simd_level::avx2;
+  if (__builtin_cpu_supports("sse2")) return simd_level::sse2;
+#endif
+  return simd_level::scalar;
+}
+
+namespace detail {
+inline simd_level &current_level() {
+  static simd_level level = detect_simd_level();
+  return level;
+}
+} // namespace detail
+
+inline simd_level active_simd_level() { return detail::current_level(); }
+
+// Select a code path at runtime. Requests above what the CPU supports are clamped to the detected level.
+inline void set_simd_level(simd_level level) { detail::current_level() = std::min(level, detect_simd_level()); }
+
+// Scalar fallbacks. These are also used for every element type other than float and double.
+
+template <typename T> void axpy(std::size_t n, T a, const T *x, T *y) {
+  for (std::size_t i = 0; i < n; ++i) {
+    y[i] = y[i] + a * x[i];
+  }
+}
+
+template <typename T> void add(std::size_t n, const T *x, T *y) {
+  for (std::size_t i = 0; i < n; ++i) {
+    y[i] = y[i] + x[i];
+  }
+}
+
+template <typename T> void sub(std::size_t n, const T *x, T *y) {
+  for (std::size_t i = 0; i < n; ++i) {
+    y[i] = y[i] - x[i];
+  }
+}
+
+template <typename T> void scale(std::size_t n, T a, T *x) {
+  for (std::size_t i = 0; i < n; ++i) {
+    x[i] = x[i] * a;
+  }
+}
+
+template <typename T> T dot(std::size_t n, const T *x, const T *y) {
+  T sum{};
+  for (std::size_t i = 0; i < n; ++i) {
+    sum = sum + x[i] * y[i];
+  }
+  return sum;
+}
+
+template <typename T> bool roughly_equal(std::size_t n, const T *x, const T *y, T precision) {
+  return std::equal(x, x + n, y, [precision](T first, T second) { return is_roughly_equal(first, second, precision); });
+}
+
+#ifdef THROTTLE_HAS_X86_SIMD
+namespace detail {
+
+#define THROTTLE_SSE2   __attribute__((target("sse2")))
+#define THROTTLE_AVX2   __attribute__((target("avx2,fma")))
+#define THROTTLE_AVX512 __attribute__((target("avx512f")))
+
+/* SSE2 */
+
+THROTTLE_SSE2 inline void axpy_sse2(std::size_t n, double a, const double *x, double *y) {
+  std::size_t i = 0;
+  const auto  va = _mm_set1_pd(a);
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(va, _mm_loadu_pd(x + i))));
+  }
+  kernels::axpy(n - i, a, x + i, y + i);
+}
+
+THROTTLE_SSE2 inline void axpy_sse2(std::size_t n, float a, const float *x, float *y) {
+  std::size_t i = 0;
+  const auto  va = _mm_set1_ps(a);
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(va, _mm_loadu_ps(x + i))));
+  }
+  kernels::axpy(n - i, a, x + i, y + i);
+}
+
+THROTTLE_SSE2 inline void scale_sse2(std::size_t n, double a, double *x) {
+  std::size_t i = 0;
+  const auto  va = _mm_set1_pd(a);
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(x + i, _mm_mul_pd(_mm_loadu_pd(x + i), va));
+  }
+  kernels::scale(n - i, a, x + i);
+}
+
+THROTTLE_SSE2 inline void scale_sse2(std::size_t n, float a, float *x) {
+  std::size_t i = 0;
+  const auto  va = _mm_set1_ps(a);
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(x + i), va));
+  }
+  kernels::scale(n - i, a, x + i);
+}
+
+THROTTLE_SSE2 inline double dot_sse2(std::size_t n, const double *x, const double *y) {
+  std::size_t i = 0;
+  auto        acc = _mm_setzero_pd();
+  for (; i + 2 <= n; i += 2) {
+    acc = _mm_add_pd(acc, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+  }
+  double lanes[2];
+  _mm_storeu_pd(lanes, acc);
+  return lanes[0] + lanes[1] + kernels::dot(n - i, x + i, y + i);
+}
+
+THROTTLE_SSE2 inline float dot_sse2(std::size_t n, const float *x, const float *y) {
+  std::size_t i = 0;
+  auto        acc = _mm_setzero_ps();
+  for (; i + 4 <= n; i += 4) {
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+  }
+  float lanes[4];
+  _mm_storeu_ps(lanes, acc);
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + kernels::dot(n - i, x + i, y + i);
+}
+
+THROTTLE_SSE2 inline bool roughly_equal_sse2(std::size_t n, const double *x, const double *y, double precision) {
+  std::size_t i = 0;
+  const auto  sign = _mm_set1_pd(-0.0), one = _mm_set1_pd(1.0), eps = _mm_set1_pd(precision);
+  for (; i + 2 <= n; i += 2) {
+    const auto a = _mm_loadu_pd(x + i), b = _mm_loadu_pd(y + i);
+    const auto diff = _mm_andnot_pd(sign, _mm_sub_pd(a, b));
+    const auto bound = _mm_max_pd(_mm_max_pd(_mm_andnot_pd(sign, a), _mm_andnot_pd(sign, b)), one);
+    if (_mm_movemask_pd(_mm_cmple_pd(diff, _mm_mul_pd(eps, bound))) != 0x3) return false;
+  }
+  return kernels::roughly_equal(n - i, x + i, y + i, precision);
+}
+
+THROTTLE_SSE2 inline bool roughly_equal_sse2(std::size_t n, const float *x, const float *y, float precision) {
+  std::size_t i = 0;
+  const auto  sign = _mm_set1_ps(-0.0f), one = _mm_set1_ps(1.0f), eps = _mm_set1_ps(precision);
+  for (; i + 4 <= n; i += 4) {
+    const auto a = _mm_loadu_ps(x + i), b = _mm_loadu_ps(y + i);
+    const auto diff = _mm_andnot_ps(sign, _mm_sub_ps(a, b));
+    const auto bound = _mm_max_ps(_mm_max_ps(_mm_andnot_ps(sign, a), _mm_andnot_ps(sign, b)), one);
+    if (_mm_movemask_ps(_mm_cmple_ps(diff, _mm_mul_ps(eps, bound))) != 0xf) return false;
+  }
+  return kernels::roughly_equal(n - i, x + i, y + i, precision);
+}
+
+/* AVX2 + FMA */
+
+THROTTLE_AVX2 inline void axpy_avx2(std::size_t n, double a, const double *x, double *y) {
+  std::size_t i = 0;
+  const auto  va = _mm256_set1_pd(a);
+  for (; i + 8 <= n; i += 8) {
+    const auto y0 = _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i));
+    const auto y1 = _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4));
+    _mm256_storeu_pd(y + i, y0);
+    _mm256_storeu_pd(y + i + 4, y1);
+  }
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(y + i, _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+  }
+  kernels::axpy(n - i, a, x + i, y + i);
+}
+
+THROTTLE_AVX2 inline void axpy_avx2(std::size_t n, float a, const float *x, float *y) {
+  std::size_t i = 0;
+  const auto  va = _mm256_set1_ps(a);
+  for (; i + 16 <= n; i += 16) {
+    const auto y0 = _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i));
+    const auto y1 = _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8));
+    _mm256_storeu_ps(y + i, y0);
+    _mm256_storeu_ps(y + i + 8, y1);
+  }
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(y + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+  }
+  kernels::axpy(n - i, a, x + i, y + i);
+}
+
+THROTTLE_AVX2 inline void scale_avx2(std::size_t n, double a, double *x) {
+  std::size_t i = 0;
+  const auto  va = _mm256_set1_pd(a);
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(x + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), va));
+  }
+  kernels::scale(n - i, a, x + i);
+}
+
+THROTTLE_AVX2 inline void scale_avx2(std::size_t n, float a, float *x) {
+  std::size_t i = 0;
+  const auto  va = _mm256_set1_ps(a);
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), va));
+  }
+  kernels::scale(n - i, a, x + i);
+}
+
+THROTTLE_AVX2 inline double dot_avx2(std::size_t n, const double *x, const double *y) {
+  std::size_t i = 0;
+  auto        acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc0);
+    acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), acc1);
+  }
+  for (; i + 4 <= n; i += 4) {
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc0);
+  }
+  double lanes[4];
+  _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + kernels::dot(n - i, x + i, y + i);
+}
+
+THROTTLE_AVX2 inline float dot_avx2(std::size_t n, const float *x, const float *y) {
+  std::size_t i = 0;
+  auto        acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc0);
+    acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), acc1);
+  }
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc0);
+  }
+  float lanes[8];
+  _mm256_storeu_ps(lanes, _mm256_add_ps(acc0, acc1));
+  float sum = 0;
+  for (auto lane : lanes) {
+    sum += lane;
+  }
+  return sum + kernels::dot(n - i, x + i, y + i);
+}
+
+THROTTLE_AVX2 inline bool roughly_equal_avx2(std::size_t n, const double *x, const double *y, double precision) {
+  std::size_t i = 0;
+  const auto  sign = _mm256_set1_pd(-0.0), one = _mm256_set1_pd(1.0), eps = _mm256_set1_pd(precision);
+  for (; i + 4 <= n; i += 4) {
+    const auto a = _mm256_loadu_pd(x + i), b = _mm256_loadu_pd(y + i);
+    const auto diff = _mm256_andnot_pd(sign, _mm256_sub_pd(a, b));
+    const auto bound = _mm256_max_pd(_mm256_max_pd(_mm256_andnot_pd(sign, a), _mm256_andnot_pd(sign, b)), one);
+    if (_mm256_movemask_pd(_mm256_cmp_pd(diff, _mm256_mul_pd(eps, bound), _CMP_LE_OQ)) != 0xf) return false;
+  }
+  return kernels::roughly_equal(n - i, x + i, y + i, precision);
+}
+
+THROTTLE_AVX2 inline bool roughly_equal_avx2(std::size_t n, const float *x, const float *y, float precision) {
+  std::size_t i = 0;
+  const auto  sign = _mm256_set1_ps(-0.0f), one = _mm256_set1_ps(1.0f), eps = _mm256_set1_ps(precision);
+  for (; i + 8 <= n; i += 8) {
+    const auto a = _mm256_loadu_ps(x + i), b = _mm256_loadu_ps(y + i);
+    const auto diff = _mm256_andnot_ps(sign, _mm256_sub_ps(a, b));
+    const auto bound = _mm256_max_ps(_mm256_max_ps(_mm256_andnot_ps(sign, a), _mm256_andnot_ps(sign, b)), one);
+    if (_mm256_movemask_ps(_mm256_cmp_ps(diff, _mm256_mul_ps(eps, bound), _CMP_LE_OQ)) != 0xff) return false;
+  }
+  return kernels::roughly_equal(n - i, x + i, y + i, precision);
+}
+
+/* AVX-512F */
+
+THROTTLE_AVX512 inline void axpy_avx512(std::size_t n, double a, const double *x, double *y) {
+  std::size_t i = 0;
+  const auto  va = _mm512_set1_pd(a);
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(y + i, _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+  }
+  if (i < n) {
+    const __mmask8 mask = (1u << (n - i)) - 1;
+    const auto     res = _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+    _mm512_mask_storeu_pd(y + i, mask, res);
+  }
+}
+
+THROTTLE_AVX512 inline void axpy_avx512(std::size_t n, float a, const float *x, float *y) {
+  std::size_t i = 0;
+  const auto  va = _mm512_set1_ps(a);
+  for (; i + 16 <= n; i += 16) {
+    _mm512_storeu_ps(y + i, _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+  }
+  if (i < n) {
+    const __mmask16 mask = (1u << (n - i)) - 1;
+    const auto      res = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i));
+    _mm512_mask_storeu_ps(y + i, mask, res);
+  }
+}
+
+THROTTLE_AVX512 inline void scale_avx512(std::size_t n, double a, double *x) {
+  std::size_t i = 0;
+  const auto  va = _mm512_set1_pd(a);
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(x + i, _mm512_mul_pd(_mm512_loadu_pd(x + i), va));
+  }
+  kernels::scale(n - i, a, x + i);
+}
+
+THROTTLE_AVX512 inline void scale_avx512(std::size_t n, float a, float *x) {
+  std::size_t i = 0;
+  const auto  va = _mm512_set1_ps(a);
+  for (; i + 16 <= n; i += 16) {
+    _mm512_storeu_ps(x + i, _mm512_mul_ps(_mm512_loadu_ps(x + i), va));
+  }
+  kernels::scale(n - i, a, x + i);
+}
+
+THROTTLE_AVX512 inline double dot_avx512(std::size_t n, const double *x, const double *y) {
+  std::size_t i = 0;
+  auto        acc = _mm512_setzero_pd();
+  for (; i + 8 <= n; i += 8) {
+    acc = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), acc);
+  }
+  double lanes[8];
+  _mm512_storeu_pd(lanes, acc);
+  double sum = 0;
+  for (auto lane : lanes) {
+    sum += lane;
+  }
+  return sum + kernels::dot(n - i, x + i, y + i);
+}
+
+THROTTLE_AVX512 inline float dot_avx512(std::size_t n, const float *x, const float *y) {
+  std::size_t i = 0;
+  auto        acc = _mm512_setzero_ps();
+  for (; i + 16 <= n; i += 16) {
+    acc = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), acc);
+  }
+  float lanes[16];
+  _mm512_storeu_ps(lanes, acc);
+  float sum = 0;
+  for (auto lane : lanes) {
+    sum += lane;
+  }
+  return sum + kernels::dot(n - i, x + i, y + i);
+}
+
+THROTTLE_AVX512 inline bool roughly_equal_avx512(std::size_t n, const double *x, const double *y, double precision) {
+  std::size_t i = 0;
+  const auto  eps = _mm512_set1_pd(precision);
+  for (; i + 8 <= n; i += 8) {
+    const auto a = _mm512_loadu_pd(x + i), b = _mm512_loadu_pd(y + i);
+    const auto diff = _mm512_abs_pd(_mm512_sub_pd(a, b));
+    // Same as diff <= eps * max(|a|, |b|, 1), spelled without _mm512_max that trips -Wuninitialized in GCC 12.
+    const auto within = _mm512_cmp_pd_mask(diff, eps, _CMP_LE_OQ) |
+                        _mm512_cmp_pd_mask(diff, _mm512_mul_pd(eps, _mm512_abs_pd(a)), _CMP_LE_OQ) |
+                        _mm512_cmp_pd_mask(diff, _mm512_mul_pd(eps, _mm512_abs_pd(b)), _CMP_LE_OQ);
+    if (within != 0xff) return false;
+  }
+  return kernels::roughly_equal(n - i, x + i, y + i, precision);
+}
+
+THROTTLE_AVX512 inline bool roughly_equal_avx512(std::size_t n, const float *x, const float *y, float precision) {
+  std::size_t i = 0;
+  const auto  eps = _mm512_set1_ps(precision);
+  for (; i + 16 <= n; i += 16) {
+    const auto a = _mm512_loadu_ps(x + i), b = _mm512_loadu_ps(y + i);
+    const auto diff = _mm512_abs_ps(_mm512_sub_ps(a, b));
+    const auto within = _mm512_cmp_ps_mask(diff, eps, _CMP_LE_OQ) |
+                        _mm512_cmp_ps_mask(diff, _mm512_mul_ps(eps, _mm512_abs_ps(a)), _CMP_LE_OQ) |
+                        _mm512_cmp_ps_mask(diff, _mm512_mul_ps(eps, _mm512_abs_ps(b)), _CMP_LE_OQ);
+    if (within != 0xffff) return false;
+  }
+  return kernels::roughly_equal(n - i, x + i, y + i, precision);
+}
+
+#undef THROTTLE_SSE2
+#undef THROTTLE_AVX2
+#undef THROTTLE_AVX512
+
+} // namespace detail
+
+// Dispatching overloads for float and double. The non-template overloads win over the scalar templates above.
+
+inline void axpy(std::size_t n, double a, const double *x, double *y) {
+  switch (active_simd_level()) {
+  case simd_level::avx512: return detail::axpy_avx512(n, a, x, y);
+  case simd_level::avx2: return detail::axpy_avx2(n, a, x, y);
+  case simd_level::sse2: return detail::axpy_sse2(n, a, x, y);
+  default: return axpy<double>(n, a, x, y);
+  }
+}
+
+inline void axpy(std::size_t n, float a, const float *x, float *y) {
+  switch (active_simd_level()) {
+  case simd_level::avx512: return detail::axpy_avx512(n, a, x, y);
+  case simd_level::avx2: return detail::axpy_avx2(n, a, x, y);
+  case simd_level::sse2: return detail::axpy_sse2(n, a, x, y);
+  default: return axpy<float>(n, a, x, y);
+  }
+}
+
+// Multiplication by one is exact, so these give the same result as a plain sum or difference.
+inline void add(std::size_t n, const double *x, double *y) { axpy(n, 1.0, x, y); }
+inline void add(std::size_t n, const float *x, float *y) { axpy(n, 1.0f, x, y); }
+inline void sub(std::size_t n, const double *x, double *y) { axpy(n, -1.0, x, y); }
+inline void sub(std::size_t n, const float *x, float *y) { axpy(n, -1.0f, x, y); }
+
+inline void scale(std::size_t n, double a, double *x) {
+  switch (active_simd_level()) {
+  case simd_level::avx512: return detail::scale_avx512(n, a, x);
+  case simd_level::avx2: return detail::scale_avx2(n, a, x);
+  case simd_level::sse2: return detail::scale_sse2(n, a, x);
+  default: return scale<double>(n, a, x);
+  }
+}
+
+inline void scale(std::size_t n, float a, float *x) {
+  switch (active_simd_level()) {
+  case simd_level::avx512: return detail::scale_avx512(n, a, x);
+  case simd_level::avx2: return detail::scale_avx2(n, a, x);
+  case simd_level::sse2: return detail::scale_sse2(n, a, x);
+  default: return scale<float>(n, a, x);
+  }
+}
+
+inline double dot(std::size_t n, const double *x, const double *y) {
+  switch (active_simd_level()) {
+  case simd_level::avx512: return detail::dot_avx512(n, x, y);
+  case simd_level::avx2: return detail::dot_avx2(n, x, y);
+  case simd_level::sse2: return detail::dot_sse2(n, x, y);
+  default: return dot<double>(n, x, y);
+  }
+}
+
+inline float dot(std::size_t n, const float *x, const float *y) {
+  switch (active_simd_level()) {
+  case simd_level::avx512: return detail::dot_avx512(n, x, y);
+  case simd_level::avx2: return detail::dot_avx2(n, x, y);
+  case simd_level::sse2: return detail::dot_sse2(n, x, y);
+  default: return dot<float>(n, x, y);
+  }
+}
+
+inline bool roughly_equal(std::size_t n, const double *x, const double *y, double precision) {
+  switch (active_simd_level()) {
+  case simd_level::avx512: return detail::roughly_equal_avx512(n, x, y, precision);
+  case simd_level::avx2: return detail::roughly_equal_avx2(n, x, y, precision);
+  case simd_level::sse2: return detail::roughly_equal_sse2(n, x, y, precision);
+  default: return roughly_equal<double>(n, x, y, precision);
+  }
+}
+
+inline bool roughly_equal(std::size_t n, const float *x, const float *y, float precision) {
+  switch (active_simd_level()) {
+  case simd_level::avx512: return detail::roughly_equal_avx512(n, x, y, precision);
+  case simd_level::avx2: return detail::roughly_equal_avx2(n, x, y, precision);
+  case simd_level::sse2: return detail::roughly_equal_sse2(n, x, y, precision);
+  default: return roughly_equal<float>(n, x, y, precision);
+  }
+}
+#endif
+
+} // namespace throttle::linmath::kernels
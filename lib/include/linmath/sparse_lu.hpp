@@ -0,0 +1,367 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Sparse direct LU factorization P * A * Q = L * U.
+ * Columns are permuted up front with a fill-reducing ordering, rows are chosen during the factorization with threshold
+ * partial pivoting. The numeric part is the left-looking Gilbert-Peierls algorithm: column k of L and U is a sparse
+ * triangular solve with the already computed part of L, whose nonzero pattern is found by a depth-first search. Total
+ * work is proportional to the number of floating point operations, not to n^2.
+ *
+ * Modified nodal analysis matrices are indefinite (the rows for short circuit currents have a zero diagonal), so the
+ * diagonal entry is preferred as long as it's within pivot_threshold of the largest candidate in its column.
+ */
+
+#pragma once
+
+#include "contiguous_matrix.hpp"
+#include "minimum_degree.hpp"
+#include "simd_kernels.hpp"
+#include "sparse_matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace throttle::linmath {
+
+template <std::floating_point T> class sparse_lu final {
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using matrix_type = sparse_matrix<value_type>;
+
+  struct options {
+    value_type pivot_threshold = 0.1; // 1.0 is plain partial pivoting, 0.0 always takes the diagonal when possible
+    value_type singular_tolerance = 1024 * std::numeric_limits<value_type>::epsilon(); // Relative to column maximum
+    bool       reorder = true;                                                          // Use a fill-reducing order
+  };
+
+private:
+  static constexpr size_type none = std::numeric_limits<size_type>::max();
+
+  size_type              m_size = 0;
+  bool                   m_singular = false;
+  std::vector<size_type> m_row_perm; // m_row_perm[k] is the original row of the k-th pivot
+  std::vector<size_type> m_col_perm; // m_col_perm[k] is the original column eliminated at step k
+  matrix_type            m_lower;    // Unit lower triangular, CSC, so the diagonal is the first entry of each column
+  matrix_type            m_upper;    // Upper triangular, CSC, so the diagonal is the last entry of each column
+
+  struct factorization_workspace {
+    std::vector<size_type>  l_offsets, l_indices, u_offsets, u_indices;
+    std::vector<value_type> l_values, u_values;
+
+    std::vector<size_type>  pinv, pattern, stack, positions;
+    std::vector<bool>       marked;
+    std::vector<value_type> x;
+
+    factorization_workspace(size_type n, size_type nnz)
+        : pinv(n, none), pattern(n), stack(n), positions(n), marked(n, false), x(n, value_type{}) {
+      l_offsets.reserve(n + 1);
+      u_offsets.reserve(n + 1);
+      l_indices.reserve(2 * nnz + n);
+      l_values.reserve(2 * nnz + n);
+      u_indices.reserve(2 * nnz + n);
+      u_values.reserve(2 * nnz + n);
+    }
+
+    // Non-recursive depth-first search from row j in the graph of the current L. Finished nodes are pushed onto
+    // pattern[--top], which yields a topological order for the triangular solve.
+    size_type depth_first_search(size_type j, size_type top) {
+      size_type head = 0;
+      stack[0] = j;
+
+      while (true) {
+        j = stack[head];
+        const auto column = pinv[j];
+
+        if (!marked[j]) {
+          marked[j] = true;
+          positions[head] = (column == none ? 0 : l_offsets[column]);
+        }
+
+        const auto finish = (column == none ? 0 : l_offsets[column + 1]);
+        bool       done = true;
+
+        for (auto p = positions[head]; p < finish; ++p) {
+          const auto i = l_indices[p];
+          if (marked[i]) continue;
+          positions[head] = p + 1;
+          stack[++head] = i;
+          done = false;
+          break;
+        }
+
+        if (!done) continue;
+
+        pattern[--top] = j;
+        if (head-- == 0) break;
+      }
+
+      return top;
+    }
+
+    // Solve L * x = A(:, col) for the rows reachable from A(:, col). Returns the start of the pattern in [top, n).
+    size_type triangular_solve(const matrix_type &mat, size_type col) {
+      const auto &offsets = mat.offsets();
+      const auto &indices = mat.indices();
+      const auto &values = mat.values();
+      const auto  n = pinv.size();
+
+      size_type top = n;
+      for (auto p = offsets[col]; p < offsets[col + 1]; ++p) {
+        if (!marked[indices[p]]) top = depth_first_search(indices[p], top);
+      }
+
+      for (auto p = top; p < n; ++p) {
+        marked[pattern[p]] = false;
+        x[pattern[p]] = value_type{};
+      }
+
+      for (auto p = offsets[col]; p < offsets[col + 1]; ++p) {
+        x[indices[p]] = values[p];
+      }
+
+      for (auto px = top; px < n; ++px) {
+        const auto j = pattern[px];
+        const auto column = pinv[j];
+        if (column == none) continue;
+
+        // The diagonal of L is unity and comes first, so skip it.
+        for (auto p = l_offsets[column] + 1; p < l_offsets[column + 1]; ++p) {
+          x[l_indices[p]] -= l_values[p] * x[j];
+        }
+      }
+
+      return top;
+    }
+  };
+
+  // Columns come out in the order of the depth-first search, while sparse_matrix wants the indices of a slice sorted.
+  // In pivot order the diagonal is the smallest index of a column of L and the largest of a column of U, so sorting
+  // keeps it first and last respectively.
+  static void sort_columns(const std::vector<size_type> &offsets, std::vector<size_type> &indices,
+                           std::vector<value_type> &values) {
+    std::vector<std::pair<size_type, value_type>> column;
+
+    for (size_type j = 0; j + 1 < offsets.size(); ++j) {
+      const auto first = offsets[j], last = offsets[j + 1];
+
+      column.clear();
+      for (auto p = first; p < last; ++p) {
+        column.emplace_back(indices[p], values[p]);
+      }
+
+      std::sort(column.begin(), column.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+      for (auto p = first; p < last; ++p) {
+        std::tie(indices[p], values[p]) = column[p - first];
+      }
+    }
+  }
+
+  void factorize(const matrix_type &mat, const options &opts) {
+    const auto n = m_size;
+
+    factorization_workspace ws{n, mat.nonzeros()};
+    auto                   &x = ws.x;
+
+    for (size_type k = 0; k < n; ++k) {
+      ws.l_offsets.push_back(ws.l_indices.size());
+      ws.u_offsets.push_back(ws.u_indices.size());
+
+      const auto col = m_col_perm[k];
+      const auto top = ws.triangular_solve(mat, col);
+
+      value_type column_max{};
+      for (auto p = mat.offsets()[col]; p < mat.offsets()[col + 1]; ++p) {
+        column_max = std::max(column_max, std::abs(mat.values()[p]));
+      }
+
+      // Step 1. Entries in already pivoted rows go to U, the largest of the others is the pivot candidate.
+      size_type  pivot_row = none;
+      value_type largest = -1;
+
+      for (auto p = top; p < n; ++p) {
+        const auto i = ws.pattern[p];
+        if (ws.pinv[i] == none) {
+          if (std::abs(x[i]) > largest) {
+            largest = std::abs(x[i]);
+            pivot_row = i;
+          }
+          continue;
+        }
+
+        ws.u_indices.push_back(ws.pinv[i]);
+        ws.u_values.push_back(x[i]);
+      }
+
+      if (pivot_row == none || largest <= opts.singular_tolerance * column_max) {
+        m_singular = true;
+        return;
+      }
+
+      // Step 2. Prefer the diagonal to keep the fill-reducing ordering intact.
+      if (ws.pinv[col] == none && std::abs(x[col]) >= largest * opts.pivot_threshold) pivot_row = col;
+
+      const auto pivot = x[pivot_row];
+      ws.u_indices.push_back(k);
+      ws.u_values.push_back(pivot);
+      ws.pinv[pivot_row] = k;
+
+      // Step 3. Scale the remaining entries to get the column of L.
+      ws.l_indices.push_back(pivot_row);
+      ws.l_values.push_back(value_type{1});
+
+      for (auto p = top; p < n; ++p) {
+        const auto i = ws.pattern[p];
+        if (ws.pinv[i] == none) {
+          ws.l_indices.push_back(i);
+          ws.l_values.push_back(x[i] / pivot);
+        }
+        x[i] = value_type{};
+      }
+    }
+
+    ws.l_offsets.push_back(ws.l_indices.size());
+    ws.u_offsets.push_back(ws.u_indices.size());
+
+    // L was built with original row numbers, switch to pivot order.
+    for (auto &i : ws.l_indices) {
+      i = ws.pinv[i];
+    }
+
+    sort_columns(ws.l_offsets, ws.l_indices, ws.l_values);
+    sort_columns(ws.u_offsets, ws.u_indices, ws.u_values);
+
+    m_row_perm.resize(n);
+    for (size_type i = 0; i < n; ++i) {
+      m_row_perm[ws.pinv[i]] = i;
+    }
+
+    m_lower = matrix_type{n, n, std::move(ws.l_offsets), std::move(ws.l_indices), std::move(ws.l_values),
+                          sparse_format::csc};
+    m_upper = matrix_type{n, n, std::move(ws.u_offsets), std::move(ws.u_indices), std::move(ws.u_values),
+                          sparse_format::csc};
+  }
+
+public:
+  sparse_lu(const matrix_type &mat, const options &opts = options{}) : m_size{mat.rows()} {
+    if (!mat.square()) throw std::runtime_error("Mismatched matrix size for LU factorization");
+
+    if (opts.reorder) {
+      m_col_perm = approximate_minimum_degree(mat);
+    } else {
+      m_col_perm.resize(m_size);
+      std::iota(m_col_perm.begin(), m_col_perm.end(), size_type{0});
+    }
+
+    if (mat.format() == sparse_format::csc) factorize(mat, opts);
+    else factorize(mat.to_csc(), opts);
+  }
+
+  size_type size() const { return m_size; }
+  bool      singular() const { return m_singular; }
+
+  const matrix_type &lower() const { return m_lower; }
+  const matrix_type &upper() const { return m_upper; }
+
+  const std::vector<size_type> &row_permutation() const { return m_row_perm; }
+  const std::vector<size_type> &col_permutation() const { return m_col_perm; }
+
+  // Solve A * x = rhs with one forward and one backward substitution.
+  std::optional<std::vector<value_type>> solve(const std::vector<value_type> &rhs) const {
+    if (m_singular) return std::nullopt;
+    if (rhs.size() != m_size) throw std::runtime_error("Mismatched right hand side size");
+
+    std::vector<value_type> y(m_size);
+    for (size_type k = 0; k < m_size; ++k) {
+      y[k] = rhs[m_row_perm[k]];
+    }
+
+    const auto &l_offsets = m_lower.offsets();
+    const auto &l_indices = m_lower.indices();
+    const auto &l_values = m_lower.values();
+
+    for (size_type j = 0; j < m_size; ++j) {
+      for (auto p = l_offsets[j] + 1; p < l_offsets[j + 1]; ++p) {
+        y[l_indices[p]] -= l_values[p] * y[j];
+      }
+    }
+
+    const auto &u_offsets = m_upper.offsets();
+    const auto &u_indices = m_upper.indices();
+    const auto &u_values = m_upper.values();
+
+    for (size_type j = m_size; j-- > 0;) {
+      y[j] /= u_values[u_offsets[j + 1] - 1];
+      for (auto p = u_offsets[j]; p < u_offsets[j + 1] - 1; ++p) {
+        y[u_indices[p]] -= u_values[p] * y[j];
+      }
+    }
+
+    std::vector<value_type> x(m_size);
+    for (size_type k = 0; k < m_size; ++k) {
+      x[m_col_perm[k]] = y[k];
+    }
+
+    return x;
+  }
+
+  // Solve A * X = B for every column of B. Each nonzero of L and U is applied to a whole row of right hand sides.
+  std::optional<contiguous_matrix<value_type>> solve_batch(const contiguous_matrix<value_type> &rhs) const {
+    if (m_singular) return std::nullopt;
+    if (rhs.rows() != m_size) throw std::runtime_error("Mismatched right hand side size");
+
+    const auto                    m = rhs.cols();
+    contiguous_matrix<value_type> y{m_size, m};
+    const auto                    y_row = [&y, m](size_type i) { return y.data() + i * m; };
+
+    for (size_type k = 0; k < m_size; ++k) {
+      std::copy_n(rhs.data() + m_row_perm[k] * m, m, y_row(k));
+    }
+
+    const auto &l_offsets = m_lower.offsets();
+    const auto &l_indices = m_lower.indices();
+    const auto &l_values = m_lower.values();
+
+    for (size_type j = 0; j < m_size; ++j) {
+      for (auto p = l_offsets[j] + 1; p < l_offsets[j + 1]; ++p) {
+        kernels::axpy(m, -l_values[p], y_row(j), y_row(l_indices[p]));
+      }
+    }
+
+    const auto &u_offsets = m_upper.offsets();
+    const auto &u_indices = m_upper.indices();
+    const auto &u_values = m_upper.values();
+
+    for (size_type j = m_size; j-- > 0;) {
+      kernels::scale(m, value_type{1} / u_values[u_offsets[j + 1] - 1], y_row(j));
+      for (auto p = u_offsets[j]; p < u_offsets[j + 1] - 1; ++p) {
+        kernels::axpy(m, -u_values[p], y_row(j), y_row(u_indices[p]));
+      }
+    }
+
+    contiguous_matrix<value_type> x{m_size, m};
+    for (size_type k = 0; k < m_size; ++k) {
+      std::copy_n(y_row(k), m, x.data() + m_col_perm[k] * m);
+    }
+
+    return x;
+  }
+};
+
+} // namespace throttle::linmath
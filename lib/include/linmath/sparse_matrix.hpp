@@ -0,0 +1,355 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "contiguous_matrix.hpp"
+#include "equal.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace throttle::linmath {
+
+// Compressed sparse storage. In CSR the major dimension is the row and m_indices hold column numbers, in CSC it's the
+// other way around. Indices inside a single major slice are always kept sorted and unique.
+enum class sparse_format { csr, csc };
+
+template <typename T> struct triplet {
+  std::size_t row, col;
+  T           value;
+};
+
+template <typename T>
+requires models_ring<T>
+class sparse_matrix {
+public:
+  using value_type = T;
+  using size_type = typename std::size_t;
+  using triplet_type = triplet<T>;
+
+private:
+  size_type     m_rows = 0;
+  size_type     m_cols = 0;
+  sparse_format m_format = sparse_format::csr;
+
+  std::vector<size_type>  m_offsets = std::vector<size_type>(1, 0); // Size is (major + 1)
+  std::vector<size_type>  m_indices;
+  std::vector<value_type> m_values;
+
+  size_type major_dim() const { return (m_format == sparse_format::csr ? m_rows : m_cols); }
+  size_type minor_dim() const { return (m_format == sparse_format::csr ? m_cols : m_rows); }
+
+  // Bucket (major, minor, value) entries into compressed form. Two stable counting passes leave the minor indices
+  // sorted inside each slice, after which duplicates are adjacent and get summed. Runs in O(nnz + rows + cols).
+  template <typename t_major, typename t_minor>
+  void compress(const std::vector<triplet_type> &entries, t_major get_major, t_minor get_minor) {
+    const auto major = major_dim(), minor = minor_dim(), nnz = entries.size();
+
+    std::vector<size_type> minor_offsets(minor + 1, 0);
+    for (const auto &e : entries) {
+      ++minor_offsets[get_minor(e) + 1];
+    }
+    std::partial_sum(minor_offsets.begin(), minor_offsets.end(), minor_offsets.begin());
+
+    std::vector<size_type> by_minor(nnz);
+    for (size_type k = 0; k < nnz; ++k) {
+      by_minor[minor_offsets[get_minor(entries[k])]++] = k;
+    }
+
+    m_offsets.assign(major + 1, 0);
+    for (const auto &e : entries) {
+      ++m_offsets[get_major(e) + 1];
+    }
+    std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+
+    std::vector<size_type> next{m_offsets.begin(), std::prev(m_offsets.end())};
+    m_indices.resize(nnz);
+    m_values.resize(nnz);
+
+    for (const auto k : by_minor) {
+      const auto pos = next[get_major(entries[k])]++;
+      m_indices[pos] = get_minor(entries[k]);
+      m_values[pos] = entries[k].value;
+    }
+
+    sum_duplicates();
+  }
+
+  void sum_duplicates() {
+    size_type write = 0;
+    for (size_type i = 0, start = 0; i < major_dim(); ++i) {
+      const auto finish = m_offsets[i + 1];
+      const auto slice_start = write;
+
+      for (size_type k = start; k < finish; ++k) {
+        if (write != slice_start && m_indices[write - 1] == m_indices[k]) {
+          m_values[write - 1] = m_values[write - 1] + m_values[k];
+          continue;
+        }
+
+        m_indices[write] = m_indices[k];
+        m_values[write++] = m_values[k];
+      }
+
+      start = finish;
+      m_offsets[i + 1] = write;
+    }
+
+    m_indices.resize(write);
+    m_values.resize(write);
+  }
+
+public:
+  sparse_matrix() = default;
+
+  sparse_matrix(size_type rows, size_type cols, sparse_format format = sparse_format::csr)
+      : m_rows{rows}, m_cols{cols}, m_format{format}, m_offsets(major_dim() + 1, 0) {}
+
+  // Build from a range of triplets. Entries with the same (row, col) are summed, which is exactly what stamping a
+  // matrix element by element needs.
+  template <std::input_iterator it>
+  sparse_matrix(size_type rows, size_type cols, it start, it finish, sparse_format format = sparse_format::csr)
+      : sparse_matrix{rows, cols, format} {
+    std::vector<triplet_type> entries{start, finish};
+
+    for (const auto &e : entries) {
+      if (e.row >= m_rows || e.col >= m_cols) throw std::out_of_range("Triplet index out of range");
+    }
+
+    if (m_format == sparse_format::csr) {
+      compress(entries, [](const auto &e) { return e.row; }, [](const auto &e) { return e.col; });
+    } else {
+      compress(entries, [](const auto &e) { return e.col; }, [](const auto &e) { return e.row; });
+    }
+  }
+
+  // Adopt already compressed arrays, e.g. the output of a factorization. Indices inside each slice must be sorted and
+  // unique; only the array sizes are validated.
+  sparse_matrix(size_type rows, size_type cols, std::vector<size_type> offsets, std::vector<size_type> indices,
+                std::vector<value_type> values, sparse_format format = sparse_format::csr)
+      : m_rows{rows}, m_cols{cols}, m_format{format}, m_offsets(std::move(offsets)), m_indices(std::move(indices)),
+        m_values(std::move(values)) {
+    if (m_offsets.size() != major_dim() + 1 || m_indices.size() != m_values.size() ||
+        m_offsets.back() != m_indices.size())
+      throw std::invalid_argument("Malformed compressed sparse arrays");
+  }
+
+  sparse_matrix(size_type rows, size_type cols, std::initializer_list<triplet_type> list,
+                sparse_format format = sparse_format::csr)
+      : sparse_matrix{rows, cols, list.begin(), list.end(), format} {}
+
+  static sparse_matrix zero(size_type rows, size_type cols, sparse_format format = sparse_format::csr) {
+    return sparse_matrix{rows, cols, format};
+  }
+
+  static sparse_matrix unity(size_type size, sparse_format format = sparse_format::csr) {
+    sparse_matrix ret{size, size, format};
+    ret.m_indices.resize(size);
+    ret.m_values.assign(size, value_type{1});
+
+    for (size_type i = 0; i < size; ++i) {
+      ret.m_offsets[i + 1] = i + 1;
+      ret.m_indices[i] = i;
+    }
+
+    return ret;
+  }
+
+  static sparse_matrix from_dense(const contiguous_matrix<T> &dense, sparse_format format = sparse_format::csr) {
+    std::vector<triplet_type> entries;
+
+    for (size_type i = 0; i < dense.rows(); ++i) {
+      for (size_type j = 0; j < dense.cols(); ++j) {
+        if (dense[i][j] == value_type{}) continue;
+        entries.push_back({i, j, dense[i][j]});
+      }
+    }
+
+    return sparse_matrix{dense.rows(), dense.cols(), entries.begin(), entries.end(), format};
+  }
+
+  size_type     rows() const { return m_rows; }
+  size_type     cols() const { return m_cols; }
+  size_type     nonzeros() const { return m_values.size(); }
+  sparse_format format() const { return m_format; }
+  bool          square() const { return rows() == cols(); }
+
+  const std::vector<size_type>  &offsets() const { return m_offsets; }
+  const std::vector<size_type>  &indices() const { return m_indices; }
+  const std::vector<value_type> &values() const { return m_values; }
+  std::vector<value_type>       &values() { return m_values; }
+
+  // Element lookup with a binary search inside the major slice. Missing elements are structural zeros.
+  value_type at(size_type row, size_type col) const {
+    if (row >= m_rows || col >= m_cols) throw std::out_of_range("Matrix index out of range");
+
+    const auto [major, minor] = (m_format == sparse_format::csr ? std::make_pair(row, col) : std::make_pair(col, row));
+    const auto first = std::next(m_indices.begin(), m_offsets[major]),
+               last = std::next(m_indices.begin(), m_offsets[major + 1]);
+
+    const auto found = std::lower_bound(first, last, minor);
+    if (found == last || *found != minor) return value_type{};
+    return m_values[std::distance(m_indices.begin(), found)];
+  }
+
+  // Change the storage format. This is a counting transpose of the compressed arrays and costs O(nnz + rows + cols).
+  sparse_matrix convert(sparse_format format) const {
+    if (format == m_format) return *this;
+
+    sparse_matrix res{m_rows, m_cols, format};
+    const auto    major = res.major_dim();
+
+    for (const auto idx : m_indices) {
+      ++res.m_offsets[idx + 1];
+    }
+    std::partial_sum(res.m_offsets.begin(), res.m_offsets.end(), res.m_offsets.begin());
+
+    std::vector<size_type> next{res.m_offsets.begin(), std::next(res.m_offsets.begin(), major)};
+    res.m_indices.resize(nonzeros());
+    res.m_values.resize(nonzeros());
+
+    for (size_type i = 0; i < major_dim(); ++i) {
+      for (size_type k = m_offsets[i]; k < m_offsets[i + 1]; ++k) {
+        const auto pos = next[m_indices[k]]++;
+        res.m_indices[pos] = i;
+        res.m_values[pos] = m_values[k];
+      }
+    }
+
+    return res;
+  }
+
+  sparse_matrix to_csr() const { return convert(sparse_format::csr); }
+  sparse_matrix to_csc() const { return convert(sparse_format::csc); }
+
+  // CSR of a matrix has the same arrays as CSC of its transpose, so transposing is a relabel followed by a conversion
+  // back to the original format.
+  sparse_matrix &transpose() {
+    const auto format = m_format;
+    std::swap(m_rows, m_cols);
+    m_format = (format == sparse_format::csr ? sparse_format::csc : sparse_format::csr);
+    *this = convert(format);
+    return *this;
+  }
+
+  contiguous_matrix<T> to_dense() const {
+    contiguous_matrix<T> res{m_rows, m_cols};
+
+    for (size_type i = 0; i < major_dim(); ++i) {
+      for (size_type k = m_offsets[i]; k < m_offsets[i + 1]; ++k) {
+        if (m_format == sparse_format::csr) {
+          res[i][m_indices[k]] = m_values[k];
+        } else {
+          res[m_indices[k]][i] = m_values[k];
+        }
+      }
+    }
+
+    return res;
+  }
+
+  // Sparse matrix-vector product y = A * x. Cost is O(nnz + rows).
+  std::vector<value_type> multiply(const std::vector<value_type> &x) const {
+    if (x.size() != m_cols) throw std::runtime_error("Mismatched matrix sizes");
+    std::vector<value_type> y(m_rows, value_type{});
+
+    if (m_format == sparse_format::csr) {
+      for (size_type i = 0; i < m_rows; ++i) {
+        value_type sum{};
+        for (size_type k = m_offsets[i]; k < m_offsets[i + 1]; ++k) {
+          sum = sum + m_values[k] * x[m_indices[k]];
+        }
+        y[i] = sum;
+      }
+    } else {
+      for (size_type j = 0; j < m_cols; ++j) {
+        for (size_type k = m_offsets[j]; k < m_offsets[j + 1]; ++k) {
+          y[m_indices[k]] = y[m_indices[k]] + m_values[k] * x[j];
+        }
+      }
+    }
+
+    return y;
+  }
+
+  // Sparse matrix product with Gustavson's row-by-row algorithm. Both operands are used in CSR and so is the result.
+  // Cost is proportional to the number of scalar multiplications plus the size of the result.
+  sparse_matrix multiply(const sparse_matrix &rhs) const {
+    if (m_cols != rhs.m_rows) throw std::runtime_error("Mismatched matrix sizes");
+    if (m_format != sparse_format::csr) return to_csr().multiply(rhs);
+    if (rhs.m_format != sparse_format::csr) return multiply(rhs.to_csr());
+
+    constexpr auto          unused = std::numeric_limits<size_type>::max();
+    std::vector<size_type>  marker(rhs.m_cols, unused), offsets(m_rows + 1, 0), indices;
+    std::vector<value_type> accumulator(rhs.m_cols), values;
+
+    for (size_type i = 0; i < m_rows; ++i) {
+      const auto row_start = indices.size();
+
+      for (size_type p = m_offsets[i]; p < m_offsets[i + 1]; ++p) {
+        const auto k = m_indices[p];
+        for (size_type q = rhs.m_offsets[k]; q < rhs.m_offsets[k + 1]; ++q) {
+          const auto j = rhs.m_indices[q];
+          const auto product = m_values[p] * rhs.m_values[q];
+
+          if (marker[j] != i) {
+            marker[j] = i;
+            indices.push_back(j);
+            accumulator[j] = product;
+          } else {
+            accumulator[j] = accumulator[j] + product;
+          }
+        }
+      }
+
+      std::sort(std::next(indices.begin(), row_start), indices.end());
+      for (auto k = row_start; k < indices.size(); ++k) {
+        values.push_back(accumulator[indices[k]]);
+      }
+
+      offsets[i + 1] = indices.size();
+    }
+
+    return sparse_matrix{m_rows, rhs.m_cols, std::move(offsets), std::move(indices), std::move(values)};
+  }
+
+  sparse_matrix &operator*=(value_type rhs) {
+    std::transform(m_values.begin(), m_values.end(), m_values.begin(), [rhs](auto &&val) { return val * rhs; });
+    return *this;
+  }
+
+  bool equal(const sparse_matrix &other, const value_type &precision = default_precision<value_type>::m_prec) const {
+    return to_dense().equal(other.to_dense(), precision);
+  }
+};
+
+// clang-format off
+template <typename T> std::vector<T> operator*(const sparse_matrix<T> &lhs, const std::vector<T> &rhs) { return lhs.multiply(rhs); }
+template <typename T> sparse_matrix<T> operator*(const sparse_matrix<T> &lhs, const sparse_matrix<T> &rhs) { return lhs.multiply(rhs); }
+template <typename T> sparse_matrix<T> operator*(const sparse_matrix<T> &lhs, T rhs) { auto res = lhs; res *= rhs; return res; }
+template <typename T> sparse_matrix<T> operator*(T lhs, const sparse_matrix<T> &rhs) { auto res = rhs; res *= lhs; return res; }
+
+template <typename T> bool operator==(const sparse_matrix<T> &lhs, const sparse_matrix<T> &rhs) { return lhs.equal(rhs); }
+template <typename T> bool operator!=(const sparse_matrix<T> &lhs, const sparse_matrix<T> &rhs) { return !(lhs.equal(rhs)); }
+template <typename T> sparse_matrix<T> transpose(const sparse_matrix<T> &mat) { auto res = mat; res.transpose(); return res; }
+// clang-format on
+
+using sparse_matrix_d = sparse_matrix<double>;
+using sparse_matrix_f = sparse_matrix<float>;
+
+} // namespace throttle::linmath
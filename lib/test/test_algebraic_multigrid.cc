@@ -0,0 +1,160 @@
+#include "linmath/algebraic_multigrid.hpp"
+#include "linmath/conjugate_gradient.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+
+namespace linmath = throttle::linmath;
+
+using matrix = linmath::sparse_matrix<double>;
+using dense = linmath::contiguous_matrix<double>;
+using multigrid = linmath::algebraic_multigrid<double>;
+using solver = linmath::conjugate_gradient_solver<double>;
+
+namespace {
+
+// Grounded Laplacian of a rows x cols grid of unit resistors, node 0 is tied to the ground with a unit resistor.
+matrix grid_laplacian(std::size_t rows, std::size_t cols) {
+  std::vector<linmath::triplet<double>> entries;
+  const auto                            index = [cols](std::size_t i, std::size_t j) { return i * cols + j; };
+
+  const auto stamp = [&entries](std::size_t a, std::size_t b) {
+    entries.push_back({a, a, 1});
+    entries.push_back({b, b, 1});
+    entries.push_back({a, b, -1});
+    entries.push_back({b, a, -1});
+  };
+
+  for (std::size_t i = 0; i < rows; ++i) {
+    for (std::size_t j = 0; j < cols; ++j) {
+      if (i + 1 < rows) stamp(index(i, j), index(i + 1, j));
+      if (j + 1 < cols) stamp(index(i, j), index(i, j + 1));
+    }
+  }
+
+  entries.push_back({0, 0, 1});
+  return matrix{rows * cols, rows * cols, entries.begin(), entries.end()};
+}
+
+double residual(const matrix &a, const std::vector<double> &x, const std::vector<double> &b) {
+  auto   ax = a * x;
+  double res = 0;
+  for (std::size_t i = 0; i < b.size(); ++i) {
+    res = std::max(res, std::abs(ax[i] - b[i]));
+  }
+  return res;
+}
+
+} // namespace
+
+TEST(test_algebraic_multigrid, test_small_direct) {
+  // Smaller than coarse_size, so the hierarchy is a single level solved by LU.
+  const matrix a = matrix::from_dense(dense{3, 3, {4, -1, 0, -1, 4, -1, 0, -1, 4}});
+  multigrid    amg{a};
+  EXPECT_EQ(amg.levels(), 1);
+
+  auto res = amg.solve({2, 4, 10});
+  ASSERT_TRUE(res.has_value());
+  EXPECT_NEAR(res.value()[0], 1, 1e-10);
+  EXPECT_NEAR(res.value()[1], 2, 1e-10);
+  EXPECT_NEAR(res.value()[2], 3, 1e-10);
+  EXPECT_EQ(amg.iterations(), 1);
+}
+
+TEST(test_algebraic_multigrid, test_hierarchy) {
+  const matrix a = grid_laplacian(64, 64);
+  multigrid    amg{a, {.coarse_size = 64}};
+
+  ASSERT_GT(amg.levels(), 2);
+  for (std::size_t l = 1; l < amg.levels(); ++l) {
+    EXPECT_LT(amg.level_size(l), amg.level_size(l - 1));
+  }
+
+  EXPECT_LE(amg.level_size(amg.levels() - 1), 64);
+  EXPECT_LT(amg.operator_complexity(), 2.0);
+}
+
+TEST(test_algebraic_multigrid, test_stationary) {
+  const matrix        a = grid_laplacian(40, 40);
+  std::vector<double> b(a.rows(), 0.0);
+  b.back() = 1;
+
+  multigrid amg{a, {.coarse_size = 32, .tolerance = 1e-8}};
+  auto      res = amg.solve(b);
+  ASSERT_TRUE(res.has_value());
+  EXPECT_LT(residual(a, res.value(), b), 1e-7);
+  EXPECT_LT(amg.iterations(), 60);
+}
+
+TEST(test_algebraic_multigrid, test_preconditioner) {
+  // The point of multigrid: the iteration count barely grows with the mesh, unlike incomplete Cholesky.
+  std::size_t previous = 0;
+  for (std::size_t side : {32, 64, 128}) {
+    const matrix        a = grid_laplacian(side, side);
+    std::vector<double> b(a.rows(), 0.0);
+    b.back() = 1;
+
+    solver amg{a, {.tolerance = 1e-10, .preconditioner = linmath::preconditioner_kind::algebraic_multigrid}};
+    solver cholesky{a, {.tolerance = 1e-10}};
+
+    auto res_amg = amg.solve(b), res_cholesky = cholesky.solve(b);
+    ASSERT_TRUE(res_amg.has_value());
+    ASSERT_TRUE(res_cholesky.has_value());
+
+    EXPECT_LT(residual(a, res_amg.value(), b), 1e-8);
+    EXPECT_LT(amg.iterations(), cholesky.iterations());
+    if (previous) {
+      EXPECT_LE(amg.iterations(), previous + 5);
+    }
+    previous = amg.iterations();
+  }
+}
+
+TEST(test_algebraic_multigrid, test_isolated_rows) {
+  // Identity rows, like the grounded node of the nodal system, are not aggregated and get solved by the smoother.
+  auto                                  a = grid_laplacian(30, 30);
+  std::vector<linmath::triplet<double>> entries;
+  for (std::size_t i = 0; i < a.rows(); ++i) {
+    for (auto p = a.offsets()[i]; p < a.offsets()[i + 1]; ++p) {
+      entries.push_back({i + 1, a.indices()[p] + 1, a.values()[p]});
+    }
+  }
+  entries.push_back({0, 0, 1});
+  const matrix extended{a.rows() + 1, a.cols() + 1, entries.begin(), entries.end()};
+
+  std::vector<double> b(extended.rows(), 1.0);
+  solver cg{extended, {.tolerance = 1e-10, .preconditioner = linmath::preconditioner_kind::algebraic_multigrid,
+                       .multigrid = {.coarse_size = 16}}};
+
+  auto res = cg.solve(b);
+  ASSERT_TRUE(res.has_value());
+  EXPECT_NEAR(res.value()[0], 1, 1e-8);
+  EXPECT_LT(residual(extended, res.value(), b), 1e-7);
+}
+
+TEST(test_algebraic_multigrid, test_large_coarsest_level) {
+  // With a single level allowed the coarsest one is the whole grid, far too large to densify. The smoother stands in
+  // for the direct solve, which still makes a usable preconditioner.
+  const auto          a = grid_laplacian(60, 60);
+  std::vector<double> b(a.rows(), 1.0);
+
+  multigrid amg{a, {.max_levels = 1}};
+  EXPECT_EQ(amg.levels(), 1);
+  EXPECT_FALSE(amg.coarse_factorized());
+
+  solver cg{a, {.tolerance = 1e-10, .preconditioner = linmath::preconditioner_kind::algebraic_multigrid,
+                .multigrid = {.max_levels = 1}}};
+
+  auto res = cg.solve(b);
+  ASSERT_TRUE(res.has_value());
+  EXPECT_LT(residual(a, res.value(), b), 1e-7);
+
+  EXPECT_TRUE((multigrid{grid_laplacian(10, 10), {.max_levels = 1}}.coarse_factorized()));
+}
+
+TEST(test_algebraic_multigrid, test_invalid) {
+  EXPECT_THROW((multigrid{matrix{2, 3}}), std::runtime_error);
+  EXPECT_THROW((multigrid{matrix::from_dense(dense{2, 2, {1, 0, 0, -1}})}), std::invalid_argument);
+}
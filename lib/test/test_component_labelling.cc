@@ -0,0 +1,64 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+#include "datastructures/component_labelling.hpp"
+
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace containers = throttle::containers;
+namespace concurrency = throttle::concurrency;
+
+using edge_list = std::vector<std::pair<std::size_t, std::size_t>>;
+
+TEST(test_component_labelling, test_small) {
+  const edge_list edges = {{3, 5}, {1, 4}, {0, 3}, {2, 2}};
+
+  for (auto parallel : {false, true}) {
+    concurrency::thread_pool pool{2};
+    const auto labelling =
+        (parallel ? containers::label_components(7, edges, pool) : containers::label_components(7, edges));
+
+    ASSERT_EQ(labelling.size(), 4);
+    EXPECT_EQ(labelling.component, (std::vector<std::size_t>{0, 1, 2, 0, 1, 0, 3}));
+    EXPECT_EQ(labelling.vertices, (std::vector<std::size_t>{3, 2, 1, 1}));
+    EXPECT_EQ(labelling.edges, (std::vector<std::size_t>{2, 1, 1, 0}));
+  }
+}
+
+TEST(test_component_labelling, test_parallel) {
+  // Sparse enough to leave many components, large enough to take several chunks.
+  constexpr std::size_t n = 400000, m = 300000;
+
+  std::mt19937                               gen{11};
+  std::uniform_int_distribution<std::size_t> dist{0, n - 1};
+  edge_list                                  edges(m);
+  for (auto &e : edges) {
+    e = {dist(gen), dist(gen)};
+  }
+
+  concurrency::thread_pool pool{4};
+  const auto               serial = containers::label_components(n, edges);
+  const auto               parallel = containers::label_components(n, edges, pool);
+
+  EXPECT_GT(serial.size(), 1);
+  EXPECT_EQ(parallel.component, serial.component);
+  EXPECT_EQ(parallel.vertices, serial.vertices);
+  EXPECT_EQ(parallel.edges, serial.edges);
+  EXPECT_EQ(std::accumulate(serial.vertices.begin(), serial.vertices.end(), std::size_t{0}), n);
+  EXPECT_EQ(std::accumulate(serial.edges.begin(), serial.edges.end(), std::size_t{0}), m);
+
+  for (const auto &[a, b] : edges) {
+    ASSERT_EQ(serial.component[a], serial.component[b]);
+  }
+}
@@ -0,0 +1,104 @@
+#include "linmath/conjugate_gradient.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+
+namespace linmath = throttle::linmath;
+
+using matrix = linmath::sparse_matrix<double>;
+using dense = linmath::contiguous_matrix<double>;
+using solver = linmath::conjugate_gradient_solver<double>;
+
+namespace {
+
+// Grounded Laplacian of a rows x cols grid of unit resistors, node 0 is tied to the ground with a unit resistor.
+matrix grid_laplacian(std::size_t rows, std::size_t cols) {
+  std::vector<linmath::triplet<double>> entries;
+  const auto                            index = [cols](std::size_t i, std::size_t j) { return i * cols + j; };
+
+  const auto stamp = [&entries](std::size_t a, std::size_t b) {
+    entries.push_back({a, a, 1});
+    entries.push_back({b, b, 1});
+    entries.push_back({a, b, -1});
+    entries.push_back({b, a, -1});
+  };
+
+  for (std::size_t i = 0; i < rows; ++i) {
+    for (std::size_t j = 0; j < cols; ++j) {
+      if (i + 1 < rows) stamp(index(i, j), index(i + 1, j));
+      if (j + 1 < cols) stamp(index(i, j), index(i, j + 1));
+    }
+  }
+
+  entries.push_back({0, 0, 1});
+  return matrix{rows * cols, rows * cols, entries.begin(), entries.end()};
+}
+
+double residual(const matrix &a, const std::vector<double> &x, const std::vector<double> &b) {
+  auto   ax = a * x;
+  double res = 0;
+  for (std::size_t i = 0; i < b.size(); ++i) {
+    res = std::max(res, std::abs(ax[i] - b[i]));
+  }
+  return res;
+}
+
+} // namespace
+
+TEST(test_conjugate_gradient, test_small) {
+  const matrix              a = matrix::from_dense(dense{3, 3, {4, -1, 0, -1, 4, -1, 0, -1, 4}});
+  const std::vector<double> b = {2, 4, 10};
+
+  for (auto kind : {linmath::preconditioner_kind::none, linmath::preconditioner_kind::jacobi,
+                    linmath::preconditioner_kind::incomplete_cholesky}) {
+    solver cg{a, {.preconditioner = kind}};
+    auto   res = cg.solve(b);
+    ASSERT_TRUE(res.has_value());
+    EXPECT_NEAR(res.value()[0], 1, 1e-8);
+    EXPECT_NEAR(res.value()[1], 2, 1e-8);
+    EXPECT_NEAR(res.value()[2], 3, 1e-8);
+    EXPECT_LE(cg.iterations(), 3);
+  }
+}
+
+TEST(test_conjugate_gradient, test_zero_rhs) {
+  solver cg{matrix::unity(5)};
+  auto   res = cg.solve(std::vector<double>(5, 0.0));
+  ASSERT_TRUE(res.has_value());
+  EXPECT_EQ(res.value(), std::vector<double>(5, 0.0));
+  EXPECT_EQ(cg.iterations(), 0);
+}
+
+TEST(test_conjugate_gradient, test_grid) {
+  const matrix        a = grid_laplacian(30, 30);
+  std::vector<double> b(a.rows(), 0.0);
+  b.back() = 1;
+
+  solver jacobi{a, {.tolerance = 1e-10, .preconditioner = linmath::preconditioner_kind::jacobi}};
+  solver cholesky{a, {.tolerance = 1e-10}};
+
+  auto res_jacobi = jacobi.solve(b), res_cholesky = cholesky.solve(b);
+  ASSERT_TRUE(res_jacobi.has_value());
+  ASSERT_TRUE(res_cholesky.has_value());
+
+  EXPECT_LT(residual(a, res_jacobi.value(), b), 1e-8);
+  EXPECT_LT(residual(a, res_cholesky.value(), b), 1e-8);
+  EXPECT_LT(cholesky.iterations(), jacobi.iterations());
+}
+
+TEST(test_conjugate_gradient, test_iteration_cap) {
+  const matrix        a = grid_laplacian(20, 20);
+  std::vector<double> b(a.rows(), 1.0);
+
+  solver cg{a, {.tolerance = 1e-12, .max_iterations = 3, .preconditioner = linmath::preconditioner_kind::none}};
+  EXPECT_FALSE(cg.solve(b).has_value());
+  EXPECT_EQ(cg.iterations(), 3);
+}
+
+TEST(test_conjugate_gradient, test_indefinite) {
+  const matrix a = matrix::from_dense(dense{2, 2, {1, 0, 0, -1}});
+  solver       cg{a, {.preconditioner = linmath::preconditioner_kind::none}};
+  EXPECT_FALSE(cg.solve({1, 1}).has_value());
+}
@@ -1,7 +1,9 @@
 #include "linmath/contiguous_matrix.hpp"
 
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <random>
 #include <vector>
 
 using matrix = throttle::linmath::contiguous_matrix<float>;
@@ -129,4 +131,63 @@ TEST(test_contiguous_matrix, test_multiplication_3) {
   auto C = A * B;
   EXPECT_TRUE(C == matrix(3, 1, {-18, -20, -16}));
   EXPECT_TRUE(A != C);
-}
\ No newline at end of file
+}
+namespace {
+
+template <typename T> throttle::linmath::contiguous_matrix<T> random_matrix(std::size_t rows, std::size_t cols) {
+  std::mt19937                            gen{static_cast<unsigned>(rows * cols)};
+  std::uniform_int_distribution<int>      dist{-9, 9};
+  throttle::linmath::contiguous_matrix<T> res{rows, cols};
+  std::generate(res.begin(), res.end(), [&] { return T(dist(gen)); });
+  return res;
+}
+
+template <typename T>
+throttle::linmath::contiguous_matrix<T> naive_product(const throttle::linmath::contiguous_matrix<T> &a,
+                                                      const throttle::linmath::contiguous_matrix<T> &b) {
+  throttle::linmath::contiguous_matrix<T> res{a.rows(), b.cols()};
+  for (std::size_t i = 0; i < a.rows(); ++i) {
+    for (std::size_t p = 0; p < a.cols(); ++p) {
+      for (std::size_t j = 0; j < b.cols(); ++j) {
+        res[i][j] += a[i][p] * b[p][j];
+      }
+    }
+  }
+  return res;
+}
+
+} // namespace
+
+TEST(test_contiguous_matrix, test_multiplication_blocked) {
+  // Sizes that leave partial tiles and partial kc/mc blocks on every edge. Small integers keep the sums exact.
+  namespace kernels = throttle::linmath::kernels;
+  const auto a = random_matrix<double>(300, 517), b = random_matrix<double>(517, 213);
+  const auto expected = naive_product(a, b);
+
+  for (auto level : {kernels::simd_level::scalar, kernels::simd_level::avx2, kernels::simd_level::avx512}) {
+    kernels::set_simd_level(level);
+    EXPECT_EQ(a * b, expected);
+  }
+  kernels::set_simd_level(kernels::detect_simd_level());
+
+  const auto af = random_matrix<float>(70, 300), bf = random_matrix<float>(300, 45);
+  EXPECT_EQ(af * bf, naive_product(af, bf));
+}
+
+TEST(test_contiguous_matrix, test_multiplication_integer) {
+  const auto a = random_matrix<long>(37, 41), b = random_matrix<long>(41, 29);
+  const auto c = a * b;
+  EXPECT_TRUE(std::equal(c.begin(), c.end(), naive_product(a, b).begin()));
+}
+
+TEST(test_contiguous_matrix, test_multiplication_pool) {
+  throttle::concurrency::thread_pool pool{4};
+
+  auto       a = random_matrix<double>(400, 300);
+  const auto b = random_matrix<double>(300, 350);
+  const auto expected = naive_product(a, b);
+
+  a.multiply(b, pool);
+  EXPECT_EQ(a, expected);
+  EXPECT_THROW(a.multiply(b, pool), std::runtime_error);
+}
@@ -0,0 +1,69 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+#include "datastructures/csr_graph.hpp"
+#include "datastructures/ud_asymmetric_graph.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+
+using graph = throttle::containers::csr_graph<int, float>;
+using hashed_graph = throttle::containers::ud_asymmetric_graph<int, float>;
+
+TEST(test_csr_graph, test_from_edges) {
+  const graph g{{10, 20, 30, 40}, {{0, 1, 1, -1}, {1, 2, 2, -2}, {0, 1, 3, -3}, {3, 3, 4, -4}}};
+
+  EXPECT_EQ(g.vertices(), 4);
+  EXPECT_EQ(g.edges(), 4);
+  EXPECT_EQ(g.label(2), 30);
+
+  EXPECT_EQ(g.degree(0), 2);
+  EXPECT_EQ(g.degree(1), 3);
+  EXPECT_EQ(g.degree(2), 1);
+  EXPECT_EQ(g.degree(3), 2);
+
+  // Parallel edges are kept apart, in the order they were given.
+  EXPECT_EQ(std::vector<std::size_t>(g.neighbours(0).begin(), g.neighbours(0).end()), (std::vector<std::size_t>{1, 1}));
+  EXPECT_EQ(std::vector<float>(g.attributes(0).begin(), g.attributes(0).end()), (std::vector<float>{1, 3}));
+  EXPECT_EQ(std::vector<float>(g.attributes(1).begin(), g.attributes(1).end()), (std::vector<float>{-1, 2, -3}));
+
+  // Every entry knows the same edge seen from the other end.
+  for (std::size_t e = 0; e < g.edges(); ++e) {
+    const auto fwd = g.edge_entry(e), bck = g.twin(fwd);
+    EXPECT_EQ(g.twin(bck), fwd);
+    EXPECT_EQ(g.attributes(0).data()[fwd - g.offset(0)], -g.attributes(0).data()[bck - g.offset(0)]);
+  }
+
+  EXPECT_THROW((graph{{1}, {{0, 1, 0, 0}}}), std::out_of_range);
+}
+
+TEST(test_csr_graph, test_from_graph) {
+  hashed_graph h;
+  h.insert_edge({1, 2}, 10, -10);
+  h.insert_edge({2, 3}, 2, -2);
+  h.insert_vertex(4);
+
+  const auto g = graph::from_graph(h);
+  ASSERT_EQ(g.vertices(), 4);
+  EXPECT_EQ(g.edges(), 2);
+
+  for (std::size_t i = 0; i < g.vertices(); ++i) {
+    const auto neighbours = g.neighbours(i);
+    const auto attributes = g.attributes(i);
+    EXPECT_EQ(neighbours.size(), g.degree(i));
+
+    for (std::size_t k = 0; k < neighbours.size(); ++k) {
+      auto found = h.lookup_edge({g.label(i), g.label(neighbours[k])});
+      ASSERT_TRUE(found.has_value());
+      EXPECT_EQ(found->first->second, attributes[k]);
+    }
+  }
+}
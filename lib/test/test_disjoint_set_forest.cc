@@ -0,0 +1,109 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+#include "datastructures/concurrent_disjoint_set_forest.hpp"
+#include "datastructures/dense_disjoint_set_forest.hpp"
+#include "datastructures/disjoint_set_forest.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace containers = throttle::containers;
+
+TEST(test_disjoint_set_forest, test_keys) {
+  containers::disjoint_set_forest<int> dsu;
+  for (int i = 0; i < 6; ++i) {
+    dsu.make_set(10 * i);
+  }
+
+  // In the second union the taller tree is on the left, so the root on the right is the one that gets relinked.
+  dsu.union_set(0, 10);
+  dsu.union_set(0, 20);
+  dsu.union_set(30, 40);
+
+  EXPECT_EQ(dsu.find_set(0), dsu.find_set(20));
+  EXPECT_EQ(dsu.find_set(10), dsu.find_set(20));
+  EXPECT_EQ(dsu.find_set(30), dsu.find_set(40));
+  EXPECT_NE(dsu.find_set(0), dsu.find_set(30));
+  EXPECT_EQ(dsu.find_set(50), 50);
+}
+
+TEST(test_disjoint_set_forest, test_long_chain) {
+  // Recursion would need a frame per link here.
+  constexpr int                        n = 1'000'000;
+  containers::disjoint_set_forest<int> dsu;
+  for (int i = 0; i < n; ++i) {
+    dsu.make_set(i);
+  }
+
+  for (int i = 1; i < n; ++i) {
+    dsu.union_set(i, i - 1);
+  }
+
+  EXPECT_EQ(dsu.find_set(0), dsu.find_set(n - 1));
+}
+
+TEST(test_disjoint_set_forest, test_dense) {
+  containers::dense_disjoint_set_forest dsu{8};
+  EXPECT_EQ(dsu.size(), 8);
+
+  EXPECT_TRUE(dsu.union_set(0, 1));
+  EXPECT_TRUE(dsu.union_set(2, 3));
+  EXPECT_TRUE(dsu.union_set(1, 3));
+  EXPECT_FALSE(dsu.union_set(0, 2));
+
+  EXPECT_TRUE(dsu.same_set(0, 3));
+  EXPECT_FALSE(dsu.same_set(0, 4));
+  EXPECT_EQ(dsu.set_size(2), 4);
+  EXPECT_EQ(dsu.set_size(7), 1);
+}
+
+TEST(test_disjoint_set_forest, test_concurrent) {
+  constexpr std::size_t n = 20000, m = 30000, threads = 4;
+
+  std::mt19937                                     gen{7};
+  std::uniform_int_distribution<std::size_t>       dist{0, n - 1};
+  std::vector<std::pair<std::size_t, std::size_t>> edges(m);
+  for (auto &e : edges) {
+    e = {dist(gen), dist(gen)};
+  }
+
+  containers::dense_disjoint_set_forest reference{n};
+  std::size_t                           expected = 0;
+  for (const auto &[a, b] : edges) {
+    expected += reference.union_set(a, b);
+  }
+
+  containers::concurrent_disjoint_set_forest dsu{n};
+  std::atomic<std::size_t>                   successful = 0;
+  std::vector<std::thread>                   workers;
+
+  for (std::size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      for (std::size_t i = t; i < m; i += threads) {
+        if (dsu.union_set(edges[i].first, edges[i].second)) ++successful;
+      }
+    });
+  }
+
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  // Every successful union merges two sets, so the count doesn't depend on the interleaving.
+  EXPECT_EQ(successful, expected);
+  for (std::size_t i = 0; i < n; ++i) {
+    EXPECT_EQ(dsu.same_set(i, 0), reference.same_set(i, 0)) << i;
+  }
+}
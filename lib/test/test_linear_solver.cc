@@ -53,4 +53,53 @@ TEST(test_equation_system, test_push) {
   linmath::matrix_d sol{3, 1, {-2, 3, 5}};
   auto              res = eqsys.solve();
   EXPECT_EQ(res.value(), sol);
-}
\ No newline at end of file
+}
+
+using sparse_linear_system_d = typename throttle::linmath::sparse_linear_system<double>;
+
+TEST(test_sparse_equation_system, test_1) {
+  sparse_linear_system_d eqsys{2};
+  eqsys.stamp(0, 0, 1);
+  eqsys.stamp(0, 1, -1);
+  eqsys.stamp(1, 0, 3);
+  eqsys.stamp(1, 1, 2);
+  eqsys.free_coeff(0) = 7;
+  eqsys.free_coeff(1) = 16;
+
+  auto res = eqsys.solve();
+  EXPECT_TRUE(res.has_value());
+  EXPECT_NEAR(res.value()[0], 6, 1e-9);
+  EXPECT_NEAR(res.value()[1], -1, 1e-9);
+}
+
+TEST(test_sparse_equation_system, test_stamps) {
+  sparse_linear_system_d eqsys{3, 8};
+  // Conductance stamps of a chain 0 -- 1 -- 2 with unit resistors, node 0 grounded and 1A injected into node 2.
+  eqsys.stamp(0, 0, 1);
+  eqsys.stamp(1, 1, 1);
+  eqsys.stamp(1, 1, 1);
+  eqsys.stamp(1, 2, -1);
+  eqsys.stamp(2, 2, 1);
+  eqsys.stamp(2, 1, -1);
+  eqsys.free_coeff(2) = 1;
+
+  EXPECT_EQ(eqsys.get_matrix().nonzeros(), 5);
+  EXPECT_EQ(eqsys.get_matrix().at(1, 1), 2);
+  EXPECT_EQ(eqsys.get_xtnd_matrix(), linmath::matrix_d(3, 4, {1, 0, 0, 0, 0, 2, -1, 0, 0, -1, 1, 1}));
+
+  auto res = eqsys.solve();
+  EXPECT_TRUE(res.has_value());
+  EXPECT_NEAR(res.value()[1], 1, 1e-9);
+  EXPECT_NEAR(res.value()[2], 2, 1e-9);
+}
+
+TEST(test_sparse_equation_system, test_singular) {
+  sparse_linear_system_d eqsys{2};
+  eqsys.stamp(0, 0, 1);
+  eqsys.stamp(0, 1, 1);
+  eqsys.stamp(1, 0, 2);
+  eqsys.stamp(1, 1, 2);
+  eqsys.free_coeff(0) = 1;
+
+  EXPECT_FALSE(eqsys.solve().has_value());
+}
@@ -0,0 +1,141 @@
+#include "concurrency/thread_pool.hpp"
+#include "linmath/lu_factorization.hpp"
+#include "linmath/matrix.hpp"
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace linmath = throttle::linmath;
+
+using matrix = linmath::matrix<double>;
+using lu = linmath::lu_factorization<double>;
+
+TEST(test_lu_factorization, test_solve) {
+  const matrix A{3, 3, {1, 1, 1, 0, 2, 5, 2, 5, -1}};
+  lu           factorization{A};
+
+  auto res = factorization.solve({6, -4, 27});
+  ASSERT_TRUE(res.has_value());
+  EXPECT_NEAR(res.value()[0], 5, 1e-12);
+  EXPECT_NEAR(res.value()[1], 3, 1e-12);
+  EXPECT_NEAR(res.value()[2], -2, 1e-12);
+}
+
+TEST(test_lu_factorization, test_determinant) {
+  const matrix A{3, 3, {1, 3, 2, -3, -1, -3, 2, 3, 1}};
+  lu           factorization{A};
+  EXPECT_NEAR(factorization.determinant(), -15, 1e-12);
+  EXPECT_NEAR(A.determinant(), -15, 1e-12);
+}
+
+TEST(test_lu_factorization, test_multiple_rhs) {
+  const matrix A{3, 3, {1, 1, 1, 0, 2, 5, 2, 5, -1}};
+  lu           factorization{A};
+
+  auto first = factorization.solve({0, -1, -12});
+  auto second = factorization.solve({1, 0, 2});
+  ASSERT_TRUE(first.has_value() && second.has_value());
+
+  EXPECT_EQ(linmath::matrix_d(3, 1, first.value().begin(), first.value().end()), matrix(3, 1, {2, -3, 1}));
+  EXPECT_EQ(linmath::matrix_d(3, 1, second.value().begin(), second.value().end()), matrix(3, 1, {1, 0, 0}));
+}
+
+TEST(test_lu_factorization, test_solve_batch) {
+  const matrix A{3, 3, {1, 1, 1, 0, 2, 5, 2, 5, -1}};
+  lu           factorization{A};
+
+  // Columns are the right hand sides of test_multiple_rhs.
+  auto res = factorization.solve_batch(linmath::contiguous_matrix<double>{3, 2, {0, 1, -1, 0, -12, 2}});
+  ASSERT_TRUE(res.has_value());
+  EXPECT_TRUE(res.value().equal(linmath::contiguous_matrix<double>{3, 2, {2, 1, -3, 0, 1, 0}}));
+  EXPECT_THROW(factorization.solve_batch(linmath::contiguous_matrix<double>{2, 2}), std::runtime_error);
+}
+
+TEST(test_lu_factorization, test_singular) {
+  const matrix A{3, 3, {1, 2, 3, 2, 4, 6, 0, 1, 1}};
+  lu           factorization{A};
+  EXPECT_TRUE(factorization.singular());
+  EXPECT_EQ(factorization.determinant(), 0);
+  EXPECT_FALSE(factorization.solve({1, 2, 3}).has_value());
+  EXPECT_THROW(lu{matrix(2, 3)}, std::runtime_error);
+}
+
+TEST(test_lu_factorization, test_blocked) {
+  // Larger than a single panel, so that the triangular solve and the trailing update are exercised.
+  constexpr std::size_t            n = 3 * lu::block_size + 7;
+  std::mt19937                     gen{42};
+  std::uniform_real_distribution<> dist{-1.0, 1.0};
+
+  matrix A{n, n};
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      A[i][j] = dist(gen);
+    }
+  }
+
+  std::vector<double> x(n);
+  for (auto &v : x) {
+    v = dist(gen);
+  }
+
+  const auto column = A * matrix{n, 1, x.begin(), x.end()};
+  std::vector<double> b(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    b[i] = column[i][0];
+  }
+
+  lu   factorization{A};
+  auto res = factorization.solve(b);
+  ASSERT_TRUE(res.has_value());
+  for (std::size_t i = 0; i < n; ++i) {
+    EXPECT_NEAR(res.value()[i], x[i], 1e-8);
+  }
+}
+
+TEST(test_lu_factorization, test_tiled) {
+  // Enough tiles for the panel, solve and update tasks of several steps to overlap.
+  constexpr std::size_t            n = 4 * lu::tile_size + 13;
+  std::mt19937                     gen{7};
+  std::uniform_real_distribution<> dist{-1.0, 1.0};
+
+  matrix A{n, n};
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      A[i][j] = dist(gen);
+    }
+  }
+
+  throttle::concurrency::thread_pool pool{4};
+  lu                                 sequential{A}, tiled{A, pool};
+
+  ASSERT_FALSE(tiled.singular());
+  EXPECT_EQ(tiled.permutation(), sequential.permutation());
+  EXPECT_TRUE(tiled.packed().equal(sequential.packed(), 1e-9));
+
+  std::vector<double> b(n, 1.0);
+  auto                first = sequential.solve(b), second = tiled.solve(b);
+  ASSERT_TRUE(first.has_value() && second.has_value());
+  for (std::size_t i = 0; i < n; ++i) {
+    EXPECT_NEAR(first.value()[i], second.value()[i], 1e-9);
+  }
+}
+
+TEST(test_lu_factorization, test_tiled_singular) {
+  constexpr std::size_t n = 3 * lu::tile_size + 1;
+
+  matrix A{n, n};
+  for (std::size_t i = 0; i < n; ++i) {
+    A[i][i] = 2;
+    if (i + 1 < n) A[i][i + 1] = A[i + 1][i] = -1;
+  }
+  for (std::size_t j = 0; j < n; ++j) {
+    A[n - 1][j] = A[n - 2][j]; // Two equal rows
+  }
+
+  throttle::concurrency::thread_pool pool{3};
+  lu                                 factorization{A, pool};
+  EXPECT_TRUE(factorization.singular());
+  EXPECT_EQ(factorization.determinant(), 0);
+}
@@ -117,6 +117,16 @@ TEST(test_matrix, test_multiplication_4) {
   EXPECT_EQ(C, matrix(2, 2, {58, 64, 139, 154}));
 }
 
+TEST(test_matrix, test_multiplication_swapped_rows) {
+  // Row swaps only permute the row table, the product has to follow it.
+  matrix A{3, 2, {1, 2, 3, 4, 5, 6}};
+  matrix B{2, 2, {1, 0, 1, 1}};
+  A.swap_rows(0, 2);
+  B.swap_rows(0, 1);
+
+  EXPECT_EQ(A * B, matrix(3, 2, {11, 5, 7, 3, 3, 1}));
+}
+
 TEST(test_matrix, test_max_in_row) {
   std::vector vals{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
   matrix      a(4, 3, vals.begin(), vals.end());
@@ -0,0 +1,352 @@
+#include "circuits/network_builder.hpp"
+#include "circuits/resistor_network.hpp"
+
+#include <gtest/gtest.h>
+#include <tuple>
+#include <vector>
+
+namespace circuits = throttle::circuits;
+
+using network_type = circuits::resistor_network<unsigned>;
+
+namespace {
+
+struct edge {
+  unsigned first, second;
+  double   res, emf;
+};
+
+// The Wheatstone bridge from network/resources, with a short circuit that carries the source.
+const std::vector<edge> bridge = {{0, 1, 0.0, 5.0},  {1, 2, 25.0, 0.0}, {1, 3, 60.0, 0.0},
+                                  {2, 3, 5.0, 0.0},  {2, 0, 200.0, 0.0}, {3, 0, 130.0, 0.0},
+                                  {4, 5, 10.0, 1.0}, {5, 6, 20.0, 0.0},  {6, 4, 30.0, 0.0}};
+
+network_type make_network(const std::vector<edge> &edges) {
+  network_type network;
+  for (const auto &e : edges) {
+    network.insert(e.first, e.second, e.res, e.emf);
+  }
+  return network;
+}
+
+void expect_same(const network_type::solution &lhs, const network_type::solution &rhs) {
+  ASSERT_EQ(lhs.second.size(), rhs.second.size());
+  for (const auto &[first, adj] : rhs.second) {
+    for (const auto &[second, current] : adj) {
+      EXPECT_NEAR(lhs.second.at(first).at(second), current, 1e-9) << first << " -- " << second;
+    }
+  }
+
+  for (const auto &[id, potential] : rhs.first) {
+    EXPECT_NEAR(lhs.first.at(id), potential, 1e-9) << id;
+  }
+}
+
+} // namespace
+
+TEST(test_resistor_network, test_single_solve) {
+  const auto network = make_network(bridge);
+  const auto currents = network.solve().second;
+  EXPECT_NEAR(currents.at(0).at(1), 0.051606, 1e-6);
+  EXPECT_NEAR(currents.at(2).at(3), 0.0149893, 1e-6);
+  EXPECT_NEAR(currents.at(4).at(5), 1.0 / 60, 1e-9);
+}
+
+TEST(test_resistor_network, test_batch) {
+  const auto network = make_network(bridge);
+
+  // Every assignment must give the same answer as a network built with those EMFs from the start.
+  std::vector<network_type::emf_assignment> batch;
+  std::vector<std::vector<edge>>            expected_edges;
+
+  for (unsigned i = 0; i < 150; ++i) {
+    const double source = 0.1 * i, extra = (i % 7) - 3.0, other = 0.5 * (i % 3);
+
+    network_type::emf_assignment assignment = {{{0, 1}, source}, {{3, 2}, extra}, {{5, 4}, other}};
+    batch.push_back(assignment);
+
+    auto edges = bridge;
+    edges[0].emf = source;
+    edges[3].emf = -extra; // The assignment is given for the reverse direction
+    edges[6].emf = -other;
+    expected_edges.push_back(edges);
+  }
+
+  for (auto method : {circuits::solver_method::sparse, circuits::solver_method::dense}) {
+    const auto solutions = network.solve_batch(batch, circuits::solver_options{.method = method});
+    ASSERT_EQ(solutions.size(), batch.size());
+
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      expect_same(solutions[i], make_network(expected_edges[i]).solve());
+    }
+  }
+}
+
+TEST(test_resistor_network, test_batch_conjugate_gradient) {
+  const std::vector<edge> grid = {{0, 1, 1.0, 0.0}, {1, 2, 2.0, 0.0}, {2, 3, 3.0, 0.0}, {3, 0, 4.0, 0.0},
+                                  {0, 2, 5.0, 0.0}, {1, 3, 6.0, 0.0}};
+  const auto              network = make_network(grid);
+
+  std::vector<network_type::emf_assignment> batch = {{}, {{{0, 1}, 1.0}}, {{{1, 2}, 2.0}, {{3, 0}, -1.0}}};
+  const auto solutions =
+      network.solve_batch(batch, circuits::solver_options{.method = circuits::solver_method::conjugate_gradient});
+
+  auto edges = grid;
+  expect_same(solutions[0], make_network(edges).solve());
+  edges[0].emf = 1.0;
+  expect_same(solutions[1], make_network(edges).solve());
+  edges[0].emf = 0.0;
+  edges[1].emf = 2.0;
+  edges[3].emf = -1.0;
+  expect_same(solutions[2], make_network(edges).solve());
+}
+
+TEST(test_resistor_network, test_batch_undefined) {
+  network_type network;
+  network.insert(0, 1, 0.0, 1.0);
+  network.insert(1, 2, 0.0, 0.0);
+  network.insert(2, 0, 0.0, 0.0); // A loop of ideal conductors, the current in it is undefined
+  EXPECT_THROW(network.solve_batch(std::vector<network_type::emf_assignment>(2)), circuits::circuit_error);
+  EXPECT_TRUE(network_type{}.solve_batch(std::vector<network_type::emf_assignment>(3)).size() == 3);
+}
+
+namespace {
+
+// The way the network driver inserts resistors: every edge gets two private vertices joined to its ends by short
+// circuits, so that parallel resistors stay distinct edges.
+network_type make_wrapped_network(const std::vector<edge> &edges) {
+  network_type network;
+  unsigned     next = 1000;
+  for (const auto &e : edges) {
+    const auto first = next++, second = next++;
+    network.insert(e.first, first);
+    network.insert(first, second, e.res, e.emf);
+    network.insert(second, e.second);
+  }
+  return network;
+}
+
+} // namespace
+
+TEST(test_resistor_network, test_reduction) {
+  const std::vector<edge> ladder = {{0, 1, 1.0, 0.0}, {1, 2, 2.0, 3.0},  {2, 3, 3.0, 0.0}, {3, 0, 4.0, -1.0},
+                                    {1, 4, 5.0, 0.0}, {4, 5, 6.0, 0.0},  {5, 2, 7.0, 2.0}, {5, 6, 8.0, 9.0},
+                                    {6, 7, 0.0, 4.0}, {3, 8, 0.0, 1.0},  {8, 9, 1.5, 0.0}, {9, 0, 2.5, 0.0}};
+  const std::vector<edge> parallel = {{0, 1, 1.0, 1.0}, {0, 1, 2.0, 0.0}, {1, 0, 3.0, 2.0},
+                                      {1, 2, 0.0, 1.0}, {1, 2, 4.0, 0.0}, {2, 0, 5.0, 0.0}};
+
+  for (auto method : {circuits::solver_method::sparse, circuits::solver_method::dense}) {
+    const circuits::solver_options reduced{.method = method}, full{.method = method, .reduce = false};
+
+    for (const auto &edges : {bridge, ladder}) {
+      expect_same(make_network(edges).solve(reduced), make_network(edges).solve(full));
+      expect_same(make_wrapped_network(edges).solve(reduced), make_wrapped_network(edges).solve(full));
+    }
+
+    // Parallel edges only exist in the wrapped form.
+    expect_same(make_wrapped_network(parallel).solve(reduced), make_wrapped_network(parallel).solve(full));
+  }
+
+  // Everything but the ground collapses, so the reduced system has a single unknown.
+  const auto currents = make_wrapped_network({{0, 1, 2.0, 4.0}, {1, 0, 2.0, 0.0}}).solve().second;
+  EXPECT_NEAR(currents.at(1000).at(1001), 1.0, 1e-12);
+  EXPECT_NEAR(currents.at(1002).at(1003), 1.0, 1e-12);
+}
+
+TEST(test_resistor_network, test_reduction_parallel_shorts) {
+  const std::vector<edge> edges = {{0, 1, 0.0, 1.0}, {0, 1, 0.0, 0.0}, {1, 2, 1.0, 0.0}, {2, 0, 1.0, 0.0}};
+  EXPECT_THROW(make_wrapped_network(edges).solve(), circuits::circuit_error);
+  EXPECT_THROW(make_wrapped_network(edges).solve({.reduce = false}), circuits::circuit_error);
+}
+
+TEST(test_resistor_network, test_parallel_shorts_undefined) {
+  // Two ideal conductors in parallel, the current splits between them in any proportion.
+  const std::vector<edge> edges = {{0, 1, 0.0, 1.0}, {1, 0, 0.0, 0.0}, {1, 2, 1.0, 0.0}, {2, 0, 1.0, 0.0}};
+  const auto              network = make_network(edges);
+
+  circuits::network_builder<unsigned> builder;
+  for (const auto &e : edges) {
+    builder.insert(e.first, e.second, e.res, e.emf);
+  }
+
+  for (auto reduce : {true, false}) {
+    const circuits::solver_options opts = {.reduce = reduce};
+    EXPECT_THROW(network.solve(opts), circuits::circuit_error);
+    EXPECT_THROW(network.solve_batch(std::vector<network_type::emf_assignment>(2), opts), circuits::circuit_error);
+    EXPECT_THROW(network.solve_edges(opts), circuits::circuit_error);
+    EXPECT_THROW(network.solve_indexed(opts), circuits::circuit_error);
+    EXPECT_THROW(builder.solve_edges(opts), circuits::circuit_error);
+  }
+
+  // A short circuit in parallel with a resistor is fine.
+  auto defined = edges;
+  defined[1].res = 2.0;
+  EXPECT_NO_THROW(make_network(defined).solve());
+  EXPECT_NO_THROW(make_network(defined).solve_edges());
+}
+
+TEST(test_resistor_network, test_contracted_short_circuits) {
+  // A tree of short circuits with EMFs between 0, 1, 2 and 3 makes them a single supernode.
+  const std::vector<edge> edges = {{0, 1, 0.0, 2.0}, {1, 2, 0.0, -1.0}, {1, 3, 0.0, 0.5}, {2, 4, 3.0, 0.0},
+                                   {3, 4, 6.0, 1.0}, {4, 5, 2.0, 0.0},  {5, 0, 0.0, 0.0}, {0, 2, 4.0, 0.0}};
+  const auto              network = make_network(edges);
+  const auto              expected = network.solve({.reduce = false});
+
+  EXPECT_NEAR(expected.first.at(1) - expected.first.at(0), 2.0, 1e-12);
+  EXPECT_NEAR(expected.first.at(2) - expected.first.at(1), -1.0, 1e-12);
+  EXPECT_NEAR(expected.first.at(3) - expected.first.at(1), 0.5, 1e-12);
+
+  // KCL has to hold at every vertex, short circuits included.
+  for (const auto &[id, adj] : expected.second) {
+    double sum = 0;
+    for (const auto &[second, current] : adj) {
+      sum += current;
+    }
+    EXPECT_NEAR(sum, 0.0, 1e-12) << id;
+  }
+
+  // With short circuits contracted the matrix is positive definite, so conjugate gradient handles this circuit too.
+  const circuits::solver_options cg{.method = circuits::solver_method::conjugate_gradient, .reduce = false};
+  expect_same(network.solve(cg), expected);
+  expect_same(network.solve({.method = circuits::solver_method::dense, .reduce = false}), expected);
+}
+
+TEST(test_resistor_network, test_solve_edges) {
+  const std::vector<edge> edges = {{0, 1, 1.0, 1.0}, {0, 1, 2.0, 0.0}, {1, 0, 3.0, 2.0}, {1, 2, 0.0, 1.0},
+                                   {1, 2, 4.0, 0.0}, {2, 0, 5.0, 0.0}, {3, 3, 2.0, 4.0}, {4, 5, 10.0, 1.0},
+                                   {5, 6, 20.0, 0.0}, {6, 4, 30.0, 0.0}};
+
+  // Parallel edges and self loops go straight in, the wrapped network is the reference.
+  auto reference_edges = edges;
+  reference_edges.erase(reference_edges.begin() + 6);
+  const auto reference = make_wrapped_network(reference_edges).solve({.reduce = false}).second;
+
+  for (auto reduce : {true, false}) {
+    const auto currents = make_network(edges).solve_edges({.reduce = reduce});
+    ASSERT_EQ(currents.size(), edges.size());
+    EXPECT_NEAR(currents[6], 2.0, 1e-12);
+
+    for (std::size_t i = 0, j = 0; i < edges.size(); ++i) {
+      if (i == 6) continue;
+      const auto first = 1000 + 2 * j++;
+      EXPECT_NEAR(currents[i], reference.at(first).at(first + 1), 1e-9) << i;
+    }
+  }
+
+  // The pair view sums the parallel edges.
+  const auto network = make_network(edges);
+  const auto currents = network.solve_edges();
+  EXPECT_NEAR(network.solve().second.at(0).at(1), currents[0] + currents[1] - currents[2], 1e-9);
+}
+
+TEST(test_resistor_network, test_solve_edges_undefined) {
+  EXPECT_THROW(make_network({{0, 1, 0.0, 1.0}, {0, 1, 0.0, 0.0}, {1, 0, 1.0, 0.0}}).solve_edges(),
+               circuits::circuit_error);
+  EXPECT_THROW(make_network({{0, 0, 0.0, 1.0}}).solve_edges(), circuits::circuit_error);
+  EXPECT_TRUE(network_type{}.solve_edges().empty());
+}
+
+TEST(test_resistor_network, test_parallel_components) {
+  // Rings of growing size with a battery each, so the components differ in cost and get solved out of order.
+  std::vector<edge> edges;
+  for (unsigned c = 0, base = 0; c < 12; ++c) {
+    const unsigned size = 3 + 4 * c;
+    for (unsigned i = 0; i < size; ++i) {
+      edges.push_back({base + i, base + (i + 1) % size, 1.0 + i % 3, (i == 0 ? 1.0 + c : 0.0)});
+    }
+    edges.push_back({base, base + size / 2, 2.0, 0.0});
+    base += size;
+  }
+
+  const auto network = make_network(edges);
+  const auto serial = network.solve();
+  const auto serial_edges = network.solve_edges();
+
+  for (auto method : {circuits::solver_method::dense, circuits::solver_method::sparse}) {
+    const auto parallel = network.solve({.method = method, .threads = 4});
+    const auto parallel_edges = network.solve_edges({.method = method, .threads = 4});
+
+    ASSERT_EQ(parallel.second.size(), serial.second.size());
+    for (const auto &[first, adjacent] : serial.second) {
+      for (const auto &[second, current] : adjacent) {
+        EXPECT_NEAR(parallel.second.at(first).at(second), current, 1e-9);
+      }
+    }
+
+    ASSERT_EQ(parallel_edges.size(), serial_edges.size());
+    for (std::size_t i = 0; i < serial_edges.size(); ++i) {
+      EXPECT_NEAR(parallel_edges[i], serial_edges[i], 1e-9) << i;
+    }
+  }
+
+  // An exception from any component reaches the caller.
+  edges.push_back({500, 501, 0.0, 1.0});
+  edges.push_back({501, 500, 0.0, 0.0});
+  EXPECT_THROW(make_network(edges).solve_edges({.threads = 4}), circuits::circuit_error);
+}
+
+TEST(test_resistor_network, test_solve_indexed) {
+  const std::vector<edge> edges = {{0, 1, 1.0, 1.0}, {0, 1, 2.0, 0.0}, {1, 2, 0.0, 1.0}, {2, 0, 5.0, 0.0},
+                                   {7, 8, 10.0, 3.0}, {8, 9, 0.0, 0.0}, {9, 7, 20.0, 0.0}, {4, 4, 2.0, 4.0}};
+
+  const auto network = make_network(edges);
+  const auto reference = network.solve();
+
+  for (auto reduce : {true, false}) {
+    const auto indexed = network.solve_indexed({.reduce = reduce});
+    ASSERT_EQ(indexed.vertices(), 7);
+    ASSERT_EQ(indexed.edges(), edges.size());
+    EXPECT_EQ(indexed.currents(), network.solve_edges({.reduce = reduce}));
+
+    for (std::size_t i = 0; i < indexed.vertices(); ++i) {
+      EXPECT_EQ(indexed.index(indexed.label(i)), i);
+    }
+
+    // Grounds may differ, but every voltage across an edge is the same. Vertex 4 only has a self loop, so it isn't in
+    // the graph at all.
+    EXPECT_EQ(indexed.potential_of(4), 0.0);
+    for (const auto &e : edges) {
+      if (e.first == e.second) continue;
+      EXPECT_NEAR(indexed.potential_of(e.first) - indexed.potential_of(e.second),
+                  reference.first.at(e.first) - reference.first.at(e.second), 1e-9);
+    }
+
+    EXPECT_FALSE(indexed.contains(3));
+    EXPECT_THROW(indexed.potential_of(3), std::out_of_range);
+  }
+}
+
+TEST(test_resistor_network, test_network_builder) {
+  auto edges = bridge;
+  edges.push_back({0, 1, 2.0, 0.0});
+  edges.push_back({4, 4, 2.0, 4.0});
+
+  circuits::network_builder<unsigned> builder;
+  for (const auto &e : edges) {
+    builder.insert(e.first, e.second, e.res, e.emf);
+  }
+
+  ASSERT_EQ(builder.vertices(), 7);
+  ASSERT_EQ(builder.edges(), edges.size());
+  EXPECT_EQ(builder.labels(), (std::vector<unsigned>{0, 1, 2, 3, 4, 5, 6}));
+  EXPECT_EQ(builder.solve_edges(), make_network(edges).solve_edges());
+
+  // With the numbering given up front edges go in by index, and the result doesn't change.
+  circuits::network_builder<unsigned> numbered{builder.labels()};
+  for (const auto &e : builder.edge_list()) {
+    numbered.insert_indexed(e.first, e.second, e.res, e.emf);
+  }
+
+  EXPECT_EQ(numbered.solve_edges({.threads = 4}), builder.solve_edges());
+
+  // Solving a builder that's no longer needed moves the labels into the solution.
+  const auto expected = builder.solve_indexed();
+  const auto moved = std::move(builder).solve_indexed();
+  EXPECT_EQ(moved.currents(), expected.currents());
+  for (std::size_t i = 0; i < expected.vertices(); ++i) {
+    EXPECT_EQ(moved.label(i), expected.label(i));
+    EXPECT_EQ(moved.index(expected.label(i)), i);
+  }
+  EXPECT_THROW(numbered.insert_indexed(0, 7), std::out_of_range);
+  EXPECT_THROW(circuits::network_builder<unsigned>({1, 2, 1}), std::invalid_argument);
+}
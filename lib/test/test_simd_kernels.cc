@@ -0,0 +1,97 @@
+#include "linmath/simd_kernels.hpp"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace kernels = throttle::linmath::kernels;
+
+namespace {
+
+// Every level up to the one supported by this CPU. Lengths are chosen to exercise all vector widths and tails.
+std::vector<kernels::simd_level> available_levels() {
+  std::vector<kernels::simd_level> levels;
+  for (auto level : {kernels::simd_level::scalar, kernels::simd_level::sse2, kernels::simd_level::avx2,
+                     kernels::simd_level::avx512}) {
+    if (level <= kernels::detect_simd_level()) levels.push_back(level);
+  }
+  return levels;
+}
+
+constexpr std::size_t lengths[] = {0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 33, 100};
+
+template <typename T> std::vector<T> random_vector(std::size_t n, unsigned seed) {
+  std::mt19937                      gen{seed};
+  std::uniform_real_distribution<T> dist{-10, 10};
+  std::vector<T>                    res(n);
+  for (auto &val : res) {
+    val = dist(gen);
+  }
+  return res;
+}
+
+struct level_guard {
+  ~level_guard() { kernels::set_simd_level(kernels::detect_simd_level()); }
+};
+
+template <typename T> void check_kernels(T tolerance) {
+  level_guard guard;
+
+  for (auto level : available_levels()) {
+    kernels::set_simd_level(level);
+    ASSERT_EQ(kernels::active_simd_level(), level);
+
+    for (auto n : lengths) {
+      const auto x = random_vector<T>(n, 1), y = random_vector<T>(n, 2);
+
+      auto res = y;
+      kernels::axpy(n, T{-1.5}, x.data(), res.data());
+      for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_NEAR(res[i], y[i] - T{1.5} * x[i], tolerance) << kernels::simd_level_name(level) << " n = " << n;
+      }
+
+      res = y;
+      kernels::sub(n, x.data(), res.data());
+      for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(res[i], y[i] - x[i]);
+      }
+
+      res = y;
+      kernels::scale(n, T{3}, res.data());
+      for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(res[i], y[i] * T{3});
+      }
+
+      T expected{};
+      for (std::size_t i = 0; i < n; ++i) {
+        expected += x[i] * y[i];
+      }
+      EXPECT_NEAR(kernels::dot(n, x.data(), y.data()), expected, tolerance * 100);
+
+      EXPECT_TRUE(kernels::roughly_equal(n, x.data(), x.data(), tolerance));
+      for (std::size_t i = 0; i < n; ++i) {
+        auto changed = x;
+        changed[i] += 1;
+        EXPECT_FALSE(kernels::roughly_equal(n, x.data(), changed.data(), tolerance));
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST(test_simd_kernels, test_double) { check_kernels<double>(1e-12); }
+
+TEST(test_simd_kernels, test_float) { check_kernels<float>(1e-4f); }
+
+TEST(test_simd_kernels, test_generic) {
+  std::vector<int> x = {1, 2, 3}, y = {4, 5, 6};
+  kernels::axpy(3, 2, x.data(), y.data());
+  EXPECT_EQ(y, std::vector<int>({6, 9, 12}));
+  EXPECT_EQ(kernels::dot(3, x.data(), y.data()), 6 + 18 + 36);
+}
+
+TEST(test_simd_kernels, test_clamp_level) {
+  kernels::set_simd_level(kernels::simd_level::avx512);
+  EXPECT_EQ(kernels::active_simd_level(), kernels::detect_simd_level());
+}
@@ -0,0 +1,205 @@
+#include "linmath/minimum_degree.hpp"
+#include "linmath/sparse_lu.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace linmath = throttle::linmath;
+
+using matrix = linmath::sparse_matrix<double>;
+using dense = linmath::contiguous_matrix<double>;
+using lu = linmath::sparse_lu<double>;
+
+namespace {
+
+// Grounded Laplacian of a rows x cols grid of unit resistors, node 0 is tied to the ground with a unit resistor.
+matrix grid_laplacian(std::size_t rows, std::size_t cols) {
+  std::vector<linmath::triplet<double>> entries;
+  const auto                            index = [cols](std::size_t i, std::size_t j) { return i * cols + j; };
+
+  const auto stamp = [&entries](std::size_t a, std::size_t b) {
+    entries.push_back({a, a, 1});
+    entries.push_back({b, b, 1});
+    entries.push_back({a, b, -1});
+    entries.push_back({b, a, -1});
+  };
+
+  for (std::size_t i = 0; i < rows; ++i) {
+    for (std::size_t j = 0; j < cols; ++j) {
+      if (i + 1 < rows) stamp(index(i, j), index(i + 1, j));
+      if (j + 1 < cols) stamp(index(i, j), index(i, j + 1));
+    }
+  }
+
+  entries.push_back({0, 0, 1});
+  return matrix{rows * cols, rows * cols, entries.begin(), entries.end()};
+}
+
+double residual(const matrix &a, const std::vector<double> &x, const std::vector<double> &b) {
+  auto   ax = a * x;
+  double res = 0;
+  for (std::size_t i = 0; i < b.size(); ++i) {
+    res = std::max(res, std::abs(ax[i] - b[i]));
+  }
+  return res;
+}
+
+} // namespace
+
+TEST(test_sparse_lu, test_small) {
+  const matrix              a = matrix::from_dense(dense{3, 3, {1, 1, 1, 0, 2, 5, 2, 5, -1}});
+  const std::vector<double> b = {6, -4, 27};
+
+  lu   factorization{a};
+  auto res = factorization.solve(b);
+  ASSERT_TRUE(res.has_value());
+  EXPECT_NEAR(res.value()[0], 5, 1e-9);
+  EXPECT_NEAR(res.value()[1], 3, 1e-9);
+  EXPECT_NEAR(res.value()[2], -2, 1e-9);
+}
+
+TEST(test_sparse_lu, test_zero_diagonal) {
+  // Nodal system with a short circuit current as the last unknown, the last row has a zero diagonal.
+  const matrix a = matrix::from_dense(dense{3, 3, {1, 0, 0, 0, 1, 1, 1, -1, 0}});
+  const std::vector<double> b = {0, 1, -5};
+
+  lu factorization{a};
+  EXPECT_FALSE(factorization.singular());
+
+  auto res = factorization.solve(b);
+  ASSERT_TRUE(res.has_value());
+  EXPECT_LT(residual(a, res.value(), b), 1e-12);
+  EXPECT_NEAR(res.value()[1], 5, 1e-12);
+}
+
+TEST(test_sparse_lu, test_singular) {
+  const matrix a = matrix::from_dense(dense{3, 3, {1, 2, 3, 2, 4, 6, 0, 1, 1}});
+  lu           factorization{a};
+  EXPECT_TRUE(factorization.singular());
+  EXPECT_FALSE(factorization.solve({1, 2, 3}).has_value());
+}
+
+TEST(test_sparse_lu, test_permutation) {
+  const matrix a = grid_laplacian(7, 9);
+  const auto   order = linmath::approximate_minimum_degree(a);
+
+  std::vector<std::size_t> sorted = order;
+  std::sort(sorted.begin(), sorted.end());
+
+  std::vector<std::size_t> expected(a.rows());
+  std::iota(expected.begin(), expected.end(), 0);
+  EXPECT_EQ(sorted, expected);
+}
+
+TEST(test_sparse_lu, test_fill_reduction) {
+  // Arrow matrix with the dense row and column first. Natural order fills everything, a minimum degree order puts the
+  // hub last and produces no fill at all.
+  constexpr std::size_t                 n = 50;
+  std::vector<linmath::triplet<double>> entries;
+  for (std::size_t i = 0; i < n; ++i) {
+    entries.push_back({i, i, double(n)});
+    if (i == 0) continue;
+    entries.push_back({0, i, 1});
+    entries.push_back({i, 0, 1});
+  }
+
+  const matrix a{n, n, entries.begin(), entries.end()};
+  lu           natural{a, {.reorder = false}};
+  lu           reordered{a};
+
+  EXPECT_EQ(natural.lower().nonzeros(), n * (n + 1) / 2);
+  EXPECT_EQ(reordered.lower().nonzeros(), 2 * n - 1);
+
+  const auto &order = reordered.col_permutation();
+  EXPECT_GE(std::distance(order.begin(), std::find(order.begin(), order.end(), 0)), n - 2);
+
+  std::vector<double> b(n, 1.0);
+  EXPECT_LT(residual(a, reordered.solve(b).value(), b), 1e-12);
+  EXPECT_LT(residual(a, natural.solve(b).value(), b), 1e-12);
+}
+
+TEST(test_sparse_lu, test_grid) {
+  const matrix        a = grid_laplacian(40, 40);
+  std::vector<double> b(a.rows(), 0.0);
+  b.back() = 1;
+
+  lu   factorization{a};
+  auto res = factorization.solve(b);
+  ASSERT_TRUE(res.has_value());
+  EXPECT_LT(residual(a, res.value(), b), 1e-9);
+  EXPECT_LT(factorization.lower().nonzeros(), 40 * 40 * 40);
+}
+
+TEST(test_sparse_lu, test_matches_dense) {
+  const dense d{4, 4, {0, 2, 0, 1, 3, 0, 1, 0, 0, 1, 4, 0, 2, 0, 0, 5}};
+  const std::vector<double> b = {1, 2, 3, 4};
+
+  for (auto threshold : {0.0, 0.1, 1.0}) {
+    lu   factorization{matrix::from_dense(d, linmath::sparse_format::csc), {.pivot_threshold = threshold}};
+    auto res = factorization.solve(b);
+    ASSERT_TRUE(res.has_value());
+    EXPECT_LT(residual(matrix::from_dense(d), res.value(), b), 1e-12);
+  }
+}
+
+TEST(test_sparse_lu, test_factors) {
+  // The factors are ordinary sparse matrices with sorted columns, and their product is the permuted matrix.
+  const matrix a = grid_laplacian(6, 7);
+  lu           factorization{a, {.pivot_threshold = 1.0}};
+  ASSERT_FALSE(factorization.singular());
+
+  for (const auto *factor : {&factorization.lower(), &factorization.upper()}) {
+    const auto &offsets = factor->offsets();
+    const auto &indices = factor->indices();
+    for (std::size_t j = 0; j < factor->cols(); ++j) {
+      EXPECT_TRUE(std::adjacent_find(indices.begin() + offsets[j], indices.begin() + offsets[j + 1],
+                                     std::greater_equal<>{}) == indices.begin() + offsets[j + 1]);
+    }
+  }
+
+  const auto  lower = factorization.lower().to_csr(), upper = factorization.upper().to_csr();
+  const auto &rows = factorization.row_permutation();
+  const auto &cols = factorization.col_permutation();
+
+  for (std::size_t i = 0; i < a.rows(); ++i) {
+    EXPECT_EQ(factorization.lower().at(i, i), 1);
+    for (std::size_t j = 0; j < a.cols(); ++j) {
+      double product = 0;
+      for (std::size_t k = 0; k <= std::min(i, j); ++k) {
+        product += lower.at(i, k) * upper.at(k, j);
+      }
+      EXPECT_NEAR(product, a.at(rows[i], cols[j]), 1e-12);
+    }
+  }
+}
+
+TEST(test_sparse_lu, test_solve_batch) {
+  const matrix a = grid_laplacian(10, 10);
+  lu           factorization{a};
+
+  dense rhs{a.rows(), 3};
+  for (std::size_t i = 0; i < a.rows(); ++i) {
+    rhs[i][0] = 1;
+    rhs[i][1] = (i % 2 ? 1.0 : -1.0);
+    rhs[i][2] = static_cast<double>(i);
+  }
+
+  auto res = factorization.solve_batch(rhs);
+  ASSERT_TRUE(res.has_value());
+
+  for (std::size_t j = 0; j < rhs.cols(); ++j) {
+    std::vector<double> b(a.rows());
+    for (std::size_t i = 0; i < a.rows(); ++i) {
+      b[i] = rhs[i][j];
+    }
+
+    const auto single = factorization.solve(b).value();
+    for (std::size_t i = 0; i < a.rows(); ++i) {
+      EXPECT_NEAR(res.value()[i][j], single[i], 1e-9);
+    }
+  }
+}
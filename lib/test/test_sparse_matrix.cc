@@ -0,0 +1,107 @@
+#include "linmath/sparse_matrix.hpp"
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+
+using matrix = throttle::linmath::sparse_matrix<float>;
+using dense = throttle::linmath::contiguous_matrix<float>;
+using throttle::linmath::sparse_format;
+
+TEST(test_sparse_matrix, test_zero) {
+  matrix a = matrix::zero(9, 8);
+  EXPECT_EQ(a.nonzeros(), 0);
+  EXPECT_EQ(a.to_dense(), dense::zero(9, 8));
+}
+
+TEST(test_sparse_matrix, test_unity) {
+  const matrix a = matrix::unity(10);
+  EXPECT_EQ(a.nonzeros(), 10);
+  for (int i = 0; i < 10; i++)
+    EXPECT_EQ(a.at(i, i), 1.0);
+  EXPECT_EQ(a.to_dense(), dense::unity(10));
+}
+
+TEST(test_sparse_matrix, test_triplets) {
+  const matrix a{3, 4, {{0, 1, 2}, {2, 3, 5}, {1, 0, -1}, {2, 0, 7}}};
+  EXPECT_EQ(a.nonzeros(), 4);
+  EXPECT_EQ(a.to_dense(), dense(3, 4, {0, 2, 0, 0, -1, 0, 0, 0, 7, 0, 0, 5}));
+  EXPECT_EQ(a.at(1, 1), 0);
+  EXPECT_THROW(matrix(2, 2, {{2, 0, 1}}), std::out_of_range);
+}
+
+TEST(test_sparse_matrix, test_duplicates) {
+  const matrix a{2, 2, {{0, 0, 1}, {1, 1, 2}, {0, 0, 3}, {1, 0, 4}, {1, 1, -2}, {0, 0, 5}}};
+  EXPECT_EQ(a.nonzeros(), 3);
+  EXPECT_EQ(a.at(0, 0), 9);
+  EXPECT_EQ(a.at(1, 1), 0);
+  EXPECT_EQ(a.at(1, 0), 4);
+
+  const matrix b{2, 2, {{0, 0, 1}, {0, 0, 3}, {1, 0, 4}}, sparse_format::csc};
+  EXPECT_EQ(b.nonzeros(), 2);
+  EXPECT_EQ(b.at(0, 0), 4);
+}
+
+TEST(test_sparse_matrix, test_sorted_indices) {
+  const matrix a{1, 5, {{0, 4, 1}, {0, 1, 2}, {0, 3, 3}, {0, 0, 4}}};
+  const auto  &idx = a.indices();
+  EXPECT_TRUE(std::is_sorted(idx.begin(), idx.end()));
+}
+
+TEST(test_sparse_matrix, test_convert) {
+  const dense  d{3, 3, {5, 8, 0, 0, 9, -5, 4, 0, -3}};
+  const matrix a = matrix::from_dense(d);
+  const matrix b = a.to_csc();
+
+  EXPECT_EQ(a.format(), sparse_format::csr);
+  EXPECT_EQ(b.format(), sparse_format::csc);
+  EXPECT_EQ(a.nonzeros(), 6);
+  EXPECT_EQ(b.nonzeros(), 6);
+  EXPECT_EQ(b.to_dense(), d);
+  EXPECT_EQ(b.to_csr().indices(), a.indices());
+  EXPECT_EQ(b.to_csr().offsets(), a.offsets());
+}
+
+TEST(test_sparse_matrix, test_transpose) {
+  std::vector vals{1, 0, 3, 4, 0, 6, 7, 8, 0, 0, 11, 12};
+
+  const dense d(4, 3, vals.begin(), vals.end());
+  matrix      a = matrix::from_dense(d);
+  a.transpose();
+
+  EXPECT_EQ(a.rows(), 3);
+  EXPECT_EQ(a.cols(), 4);
+  EXPECT_EQ(a.format(), sparse_format::csr);
+  EXPECT_EQ(a.to_dense(), transpose(d));
+
+  const matrix c = transpose(matrix::from_dense(d, sparse_format::csc));
+  EXPECT_EQ(c.format(), sparse_format::csc);
+  EXPECT_EQ(c, a);
+}
+
+TEST(test_sparse_matrix, test_multiplication_1) {
+  const matrix a = matrix::from_dense({3, 3, {5, 8, -4, 6, 9, -5, 4, 7, -3}});
+  const std::vector<float> x = {2, -3, 1}, expected = {-18, -20, -16};
+
+  EXPECT_EQ(a * x, expected);
+  EXPECT_EQ(a.to_csc() * x, expected);
+  EXPECT_THROW(a * std::vector<float>(2), std::runtime_error);
+}
+
+TEST(test_sparse_matrix, test_multiplication_2) {
+  const matrix a{2, 3, {{0, 2, 2}, {1, 0, 3}}};
+  const std::vector<float> x = {1, 5, 4}, expected = {8, 3};
+
+  EXPECT_EQ(a * x, expected);
+  EXPECT_EQ((a * 2.0f).to_csc() * x, std::vector<float>({16, 6}));
+}
+
+TEST(test_sparse_matrix, test_matrix_product) {
+  const dense a{2, 3, {1, 0, 2, 0, 3, 0}}, b{3, 2, {1, 2, 0, 1, 4, 0}};
+
+  const auto product = matrix::from_dense(a) * matrix::from_dense(b, sparse_format::csc);
+  EXPECT_EQ(product.format(), sparse_format::csr);
+  EXPECT_EQ(product.to_dense(), dense(2, 2, {9, 2, 0, 3}));
+  EXPECT_EQ(product.nonzeros(), 3);
+  EXPECT_THROW(matrix::from_dense(a) * matrix::from_dense(a), std::runtime_error);
+}
@@ -0,0 +1,67 @@
+#include "concurrency/task_graph.hpp"
+#include "concurrency/thread_pool.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace concurrency = throttle::concurrency;
+
+TEST(test_task_graph, test_order) {
+  concurrency::thread_pool pool{4};
+  concurrency::task_graph  graph;
+
+  std::mutex       mutex;
+  std::vector<int> order;
+  const auto       record = [&](int val) {
+    return [&, val] {
+      std::lock_guard lock{mutex};
+      order.push_back(val);
+    };
+  };
+
+  // A diamond: 0 -> {1, 2} -> 3
+  const auto a = graph.add(record(0)), b = graph.add(record(1)), c = graph.add(record(2)), d = graph.add(record(3));
+  graph.depends(b, a);
+  graph.depends(c, a);
+  graph.depends(d, b);
+  graph.depends(d, c);
+  graph.run(pool);
+
+  ASSERT_EQ(order.size(), 4);
+  EXPECT_EQ(order.front(), 0);
+  EXPECT_EQ(order.back(), 3);
+}
+
+TEST(test_task_graph, test_chain) {
+  concurrency::thread_pool pool{3};
+  concurrency::task_graph  graph;
+
+  std::atomic<int> counter = 0;
+  std::vector<int> seen(1000);
+  for (std::size_t i = 0; i < seen.size(); ++i) {
+    const auto task = graph.add([&, i] { seen[i] = counter++; });
+    if (i) graph.depends(task, task - 1);
+  }
+
+  graph.run(pool);
+  for (std::size_t i = 0; i < seen.size(); ++i) {
+    EXPECT_EQ(seen[i], static_cast<int>(i));
+  }
+}
+
+TEST(test_task_graph, test_exception) {
+  concurrency::thread_pool pool{2};
+  concurrency::task_graph  graph;
+
+  bool       ran_after = false;
+  const auto bad = graph.add([] { throw std::runtime_error("bad task"); });
+  const auto next = graph.add([&] { ran_after = true; });
+  graph.depends(next, bad);
+
+  EXPECT_THROW(graph.run(pool), std::runtime_error);
+  EXPECT_FALSE(ran_after);
+  EXPECT_THROW(graph.depends(next, 5), std::out_of_range);
+}
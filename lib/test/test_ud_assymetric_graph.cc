@@ -38,4 +38,35 @@ TEST(test_ud_asymmetric_graph, test_basics) {
   EXPECT_EQ(std::accumulate(components.begin(), components.end(), 0, [](auto a, auto b) { return a + b.edges(); }), 3);
   EXPECT_EQ(std::accumulate(components.begin(), components.end(), 0, [](auto a, auto b) { return a + b.vertices(); }),
             6);
-}
\ No newline at end of file
+}
+
+TEST(test_ud_asymmetric_graph, test_component_views) {
+  graph g;
+
+  g.insert_edge({1, 2}, 10, -10);
+  g.insert_edge({3, 4}, 5, -5);
+  g.insert_edge({2, 5}, 2, -2);
+  g.insert_edge({5, 1}, 1, -1);
+
+  const auto components = g.connected_components();
+  ASSERT_EQ(components.size(), 2);
+
+  for (const auto &comp : components) {
+    std::vector<int> ids;
+    for (const auto &v : comp) {
+      ids.push_back(v.first);
+      // The view reads the adjacency of the graph itself.
+      const auto found = std::find_if(g.begin(), g.end(), [&v](const auto &u) { return u.first == v.first; });
+      EXPECT_EQ(&found->second, &v.second);
+    }
+
+    std::sort(ids.begin(), ids.end());
+    if (comp.vertices() == 3) {
+      EXPECT_EQ(ids, (std::vector<int>{1, 2, 5}));
+      EXPECT_EQ(comp.edges(), 3);
+    } else {
+      EXPECT_EQ(ids, (std::vector<int>{3, 4}));
+      EXPECT_EQ(comp.edges(), 1);
+    }
+  }
+}
@@ -0,0 +1,162 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Binary netlist, written by netconv and read by network in place of the text.
+ * The layout is a 32 byte header, the array of edges and optionally an array of vertex labels:
+ *
+ *   char magic[8]; u32 version, flags; u64 edges, vertices;
+ *   { u32 first, second; f64 res, emf; u32 flags, reserved; } [edges]
+ *   u32 labels[vertices]
+ *
+ * Numbers are in the byte order of the machine that wrote the file, a version that reads back swapped means the other
+ * one. With has_labels the ends of an edge are dense indices 0, 1, ... in the order of first appearance, and labels
+ * maps them back to the vertex numbers of the text. Everything is aligned, so once the input is mapped (see
+ * input_buffer.hpp) the edges are read where they lie, without any parsing.
+ */
+
+#pragma once
+
+#include "edge.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace circuits {
+
+struct binary_edge {
+  enum : std::uint32_t { has_emf = 1 };
+
+  std::uint32_t first, second;
+  double        res, emf;
+  std::uint32_t flags, reserved;
+};
+
+static_assert(sizeof(binary_edge) == 32);
+
+class binary_netlist {
+public:
+  static constexpr char          magic[8] = {'N', 'E', 'T', 'L', 'I', 'S', 'T', '\0'};
+  static constexpr std::uint32_t version = 1;
+
+  enum : std::uint32_t { has_labels = 1 };
+
+  struct header {
+    char          magic[8];
+    std::uint32_t version, flags;
+    std::uint64_t edges, vertices;
+  };
+
+  static_assert(sizeof(header) == 32);
+
+private:
+  std::span<const binary_edge>   m_records;
+  std::span<const std::uint32_t> m_labels;
+  bool                           m_labelled = false;
+
+  static std::uint32_t byteswap(std::uint32_t x) {
+    return (x >> 24) | ((x >> 8) & 0xff00) | ((x << 8) & 0xff0000) | (x << 24);
+  }
+
+public:
+  static bool is_binary(std::string_view input) {
+    return input.size() >= sizeof(magic) && !std::memcmp(input.data(), magic, sizeof(magic));
+  }
+
+  explicit binary_netlist(std::string_view input) {
+    if (input.size() < sizeof(header) || !is_binary(input)) throw std::runtime_error{"Not a binary netlist"};
+    if (reinterpret_cast<std::uintptr_t>(input.data()) % alignof(binary_edge))
+      throw std::runtime_error{"Binary netlist is not aligned in memory"};
+
+    const auto &head = *reinterpret_cast<const header *>(input.data());
+    if (head.version != version) {
+      if (byteswap(head.version) == version)
+        throw std::runtime_error{"Binary netlist was written on a machine with the other byte order"};
+      throw std::runtime_error{"Unsupported binary netlist version " + std::to_string(head.version)};
+    }
+
+    if (head.flags & ~has_labels) throw std::runtime_error{"Unknown flags in the binary netlist header"};
+    if (!(head.flags & has_labels) && head.vertices) throw std::runtime_error{"Binary netlist has unflagged labels"};
+
+    const auto payload = input.size() - sizeof(header);
+    const auto fits = (head.edges <= payload / sizeof(binary_edge));
+    const auto rest = (fits ? payload - head.edges * sizeof(binary_edge) : 0);
+    if (!fits || rest % sizeof(std::uint32_t) || rest / sizeof(std::uint32_t) != head.vertices)
+      throw std::runtime_error{"Binary netlist size doesn't match its header"};
+
+    const auto records = input.data() + sizeof(header);
+    m_records = {reinterpret_cast<const binary_edge *>(records), head.edges};
+
+    m_labelled = (head.flags & has_labels);
+    if (!m_labelled) return;
+    m_labels = {reinterpret_cast<const std::uint32_t *>(records + head.edges * sizeof(binary_edge)), head.vertices};
+
+    for (const auto &e : m_records) {
+      if (e.first >= m_labels.size() || e.second >= m_labels.size())
+        throw std::runtime_error{"Binary netlist edge refers to a vertex without a label"};
+    }
+  }
+
+  std::span<const binary_edge>   records() const { return m_records; }
+  std::span<const std::uint32_t> labels() const { return m_labels; }
+  bool                           labelled() const { return m_labelled; }
+
+  // The edges like the parser returns them, computed on the fly.
+  auto edges() const {
+    return m_records | std::views::transform([labels = m_labels, labelled = m_labelled](const binary_edge &e) {
+             const auto first = (labelled ? labels[e.first] : e.first);
+             const auto second = (labelled ? labels[e.second] : e.second);
+             return network_edge{first, second, e.res,
+                                 (e.flags & binary_edge::has_emf ? std::optional{e.emf} : std::nullopt)};
+           });
+  }
+
+  static void write(std::ostream &os, const std::vector<network_edge> &edges, bool with_labels) {
+    std::vector<binary_edge>                    records;
+    std::vector<std::uint32_t>                  labels;
+    std::unordered_map<unsigned, std::uint32_t> index;
+
+    const auto intern = [&](unsigned vertex) -> std::uint32_t {
+      if (!with_labels) return vertex;
+      const auto [found, inserted] = index.try_emplace(vertex, labels.size());
+      if (inserted) labels.push_back(vertex);
+      return found->second;
+    };
+
+    records.reserve(edges.size());
+    for (const auto &e : edges) {
+      const auto first = intern(e.first);
+      const auto second = intern(e.second);
+      records.push_back({first, second, e.res, e.emf.value_or(0.0), (e.emf ? binary_edge::has_emf : 0u), 0});
+    }
+
+    header head = {};
+    std::memcpy(head.magic, magic, sizeof(magic));
+    head.version = version;
+    head.flags = (with_labels ? has_labels : 0u);
+    head.edges = records.size();
+    head.vertices = labels.size();
+
+    os.write(reinterpret_cast<const char *>(&head), sizeof(head));
+    os.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(binary_edge));
+    os.write(reinterpret_cast<const char *>(labels.data()), labels.size() * sizeof(std::uint32_t));
+    if (!os) throw std::runtime_error{"Can't write the binary netlist"};
+  }
+};
+
+} // namespace circuits
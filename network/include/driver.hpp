@@ -14,25 +14,30 @@
 #include "edge.hpp"
 #include "scanner.hpp"
 
+#include <functional>
 #include <optional>
 #include <string>
-#include <vector>
+#include <utility>
 
 namespace circuits {
 
 class driver {
+public:
+  using sink_type = std::function<void(const network_edge &)>;
+
 private:
-  scanner m_scanner;
-  parser  m_parser;
+  scanner   m_scanner;
+  parser    m_parser;
+  sink_type m_sink;
 
   friend class parser;
   friend class scanner;
 
 public:
-  std::vector<network_edge> m_parsed;
-
-  driver() : m_scanner{}, m_parser{m_scanner, *this} {}
+  // Every edge goes to sink as soon as the parser has seen all of it, in the order of the input.
+  explicit driver(sink_type sink) : m_scanner{}, m_parser{m_scanner, *this}, m_sink{std::move(sink)} {}
 
+  void emit(const network_edge &edge) { m_sink(edge); }
   void parse() { m_parser.parse(); }
   void switch_input_stream(std::istream *is) { m_scanner.switch_streams(is, nullptr); }
 };
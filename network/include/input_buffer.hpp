@@ -0,0 +1,143 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: The whole input of the program as one contiguous read-only region.
+ * Regular files, stdin redirected from a file included, are mapped with mmap, so the parser reads the page cache
+ * directly and nothing is copied. Pipes and terminals can't be mapped: they are read with read() in large blocks into a
+ * buffer that grows geometrically. memory_streambuf exposes the region as an std::istream for the flex scanner, again
+ * without a copy.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace circuits {
+
+class input_buffer {
+  std::string_view  m_view;
+  void             *m_mapping = nullptr;
+  std::vector<char> m_storage; // Used when the input can't be mapped
+
+  static std::runtime_error system_error(const std::string &what) {
+    return std::runtime_error{what + ": " + std::strerror(errno)};
+  }
+
+  explicit input_buffer(int fd) {
+    struct stat info;
+    if (::fstat(fd, &info) != 0) throw system_error("Can't stat the input");
+
+    if (S_ISREG(info.st_mode)) {
+      const auto size = static_cast<std::size_t>(info.st_size);
+      if (!size) return;
+
+      m_mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (m_mapping != MAP_FAILED) {
+        ::madvise(m_mapping, size, MADV_SEQUENTIAL);
+        m_view = {static_cast<const char *>(m_mapping), size};
+        return;
+      }
+
+      m_mapping = nullptr; // Some file systems can't map, read them instead
+    }
+
+    read_all(fd);
+  }
+
+  void read_all(int fd) {
+    constexpr std::size_t block = 1 << 20;
+    std::size_t           size = 0;
+
+    while (true) {
+      if (m_storage.size() - size < block) m_storage.resize(std::max(2 * m_storage.size(), size + block));
+
+      const auto count = ::read(fd, m_storage.data() + size, m_storage.size() - size);
+      if (count < 0) {
+        if (errno == EINTR) continue;
+        throw system_error("Can't read the input");
+      }
+
+      if (count == 0) break;
+      size += static_cast<std::size_t>(count);
+    }
+
+    m_storage.resize(size);
+    m_view = {m_storage.data(), m_storage.size()};
+  }
+
+  void release() {
+    if (m_mapping) ::munmap(m_mapping, m_view.size());
+    m_mapping = nullptr;
+  }
+
+public:
+  static input_buffer from_stdin() { return input_buffer{STDIN_FILENO}; }
+
+  static input_buffer from_file(const std::string &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw system_error("Can't open " + path);
+
+    try {
+      input_buffer result{fd};
+      ::close(fd);
+      return result;
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+  }
+
+  input_buffer(const input_buffer &) = delete;
+  input_buffer &operator=(const input_buffer &) = delete;
+
+  input_buffer(input_buffer &&rhs) noexcept
+      : m_view{std::exchange(rhs.m_view, {})}, m_mapping{std::exchange(rhs.m_mapping, nullptr)},
+        m_storage{std::move(rhs.m_storage)} {}
+
+  input_buffer &operator=(input_buffer &&rhs) noexcept {
+    if (this == &rhs) return *this;
+    release();
+    m_view = std::exchange(rhs.m_view, {});
+    m_mapping = std::exchange(rhs.m_mapping, nullptr);
+    m_storage = std::move(rhs.m_storage);
+    return *this;
+  }
+
+  ~input_buffer() { release(); }
+
+  std::string_view view() const { return m_view; }
+  bool             mapped() const { return m_mapping != nullptr; }
+};
+
+// Read-only stream buffer over memory that someone else owns.
+class memory_streambuf : public std::streambuf {
+public:
+  explicit memory_streambuf(std::string_view view) {
+    auto begin = const_cast<char *>(view.data());
+    setg(begin, begin, begin + view.size());
+  }
+};
+
+} // namespace circuits
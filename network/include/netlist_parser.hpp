@@ -0,0 +1,340 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Hand-written scanner and parser for the netlist grammar of parser.y.
+ * A netlist is a sequence of edges "first -- second, resistance; [emf V [;]]". The scanner works on the input in
+ * place: numbers are converted with std::from_chars, which neither allocates nor looks at the locale, and runs of
+ * whitespace are skipped 16 bytes at a time with SSE2. The parser is recursive descent. It tells an EMF ("5 V") from
+ * the first vertex of the next edge ("5 --") by the token after the number. Errors are reported with the same text
+ * and line number as the flex/bison parser gives.
+ *
+ * Large inputs can be parsed in parallel. The only place where "--" occurs is between the vertices of an edge, so the
+ * number in front of it always starts a statement and the input can be cut there. The pieces are parsed on a thread
+ * pool into vectors of their own, which are then handed on in order. A piece fails to parse only if the whole input
+ * does, and then it is parsed again serially, so that the error and its line are the same as without threads.
+ */
+
+#pragma once
+
+#include "concurrency/task_graph.hpp"
+#include "concurrency/thread_pool.hpp"
+#include "edge.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace circuits {
+
+class netlist_parser {
+public:
+  enum class token_kind { unsigned_number, double_number, line, semicol, comma, voltage, eof };
+
+  struct token {
+    token_kind  kind;
+    double      value = 0; // For both kinds of numbers
+    unsigned    vertex = 0;
+    std::size_t line = 0;
+  };
+
+private:
+  const char *m_cur, *m_end;
+  std::size_t m_line = 1;
+
+  token m_token;
+
+  static bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+  static bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+  void skip_space() {
+#if defined(__SSE2__)
+    const auto space = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t'), newline = _mm_set1_epi8('\n'),
+               carriage = _mm_set1_epi8('\r');
+
+    // Most tokens are separated by a single blank, the vector path only pays off for longer runs.
+    while (m_end - m_cur >= 16 && is_space(m_cur[0]) && is_space(m_cur[1])) {
+      const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(m_cur));
+      const auto lines = _mm_cmpeq_epi8(block, newline);
+      const auto blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, tab)),
+                                      _mm_or_si128(lines, _mm_cmpeq_epi8(block, carriage)));
+
+      const auto blank_mask = static_cast<unsigned>(_mm_movemask_epi8(blank));
+      const auto lines_mask = static_cast<unsigned>(_mm_movemask_epi8(lines));
+
+      if (blank_mask == 0xffff) {
+        m_line += __builtin_popcount(lines_mask);
+        m_cur += 16;
+        continue;
+      }
+
+      const auto skipped = static_cast<unsigned>(__builtin_ctz(~blank_mask));
+      m_line += __builtin_popcount(lines_mask & ((1u << skipped) - 1));
+      m_cur += skipped;
+      return;
+    }
+#endif
+
+    for (; m_cur != m_end && is_space(*m_cur); ++m_cur) {
+      if (*m_cur == '\n') ++m_line;
+    }
+  }
+
+  // The messages are those of scanner.l and parser.y, which add the line number too.
+  [[noreturn]] void unexpected_symbol() const {
+    throw std::runtime_error{"Unexpected symbol on line " + std::to_string(m_line)};
+  }
+
+  [[noreturn]] void number_out_of_range() const {
+    throw std::runtime_error{"Number out of range on line " + std::to_string(m_line)};
+  }
+
+  token scan_number() {
+    const auto start = m_cur;
+    bool       is_double = false;
+
+    if (*m_cur == '+' || *m_cur == '-') {
+      ++m_cur;
+      is_double = true;
+      if (m_cur == m_end || !is_digit(*m_cur)) unexpected_symbol();
+    }
+
+    while (m_cur != m_end && is_digit(*m_cur)) {
+      ++m_cur;
+    }
+
+    if (m_cur != m_end && *m_cur == '.') {
+      is_double = true;
+      for (++m_cur; m_cur != m_end && is_digit(*m_cur);) {
+        ++m_cur;
+      }
+    }
+
+    token result{.kind = (is_double ? token_kind::double_number : token_kind::unsigned_number), .line = m_line};
+    const auto first = (*start == '+' ? start + 1 : start);
+
+    if (is_double) {
+      const auto [ptr, ec] = std::from_chars(first, m_cur, result.value, std::chars_format::fixed);
+      if (ec == std::errc::result_out_of_range) number_out_of_range();
+      if (ec != std::errc{} || ptr != m_cur) unexpected_symbol();
+      return result;
+    }
+
+    const auto [ptr, ec] = std::from_chars(first, m_cur, result.vertex);
+    if (ec == std::errc::result_out_of_range) number_out_of_range();
+    result.value = result.vertex;
+    return result;
+  }
+
+  token scan() {
+    skip_space();
+    if (m_cur == m_end) return {.kind = token_kind::eof, .line = m_line};
+
+    const auto simple = [this](token_kind kind, std::size_t length) {
+      m_cur += length;
+      return token{.kind = kind, .line = m_line};
+    };
+
+    switch (*m_cur) {
+    case ';': return simple(token_kind::semicol, 1);
+    case ',': return simple(token_kind::comma, 1);
+    case 'V': return simple(token_kind::voltage, 1);
+    case '-':
+      if (m_end - m_cur >= 2 && m_cur[1] == '-') return simple(token_kind::line, 2);
+      return scan_number();
+    default:
+      if (*m_cur == '+' || is_digit(*m_cur)) return scan_number();
+      unexpected_symbol();
+    }
+  }
+
+  void advance() { m_token = scan(); }
+
+  // Token names as bison spells them in its messages.
+  static std::string name(token_kind kind) {
+    switch (kind) {
+    case token_kind::unsigned_number: return "unsigned";
+    case token_kind::double_number: return "double";
+    case token_kind::line: return "--";
+    case token_kind::semicol: return ";";
+    case token_kind::comma: return "\",\"";
+    case token_kind::voltage: return "V";
+    case token_kind::eof: return "end of file";
+    }
+    return "";
+  }
+
+  [[noreturn]] void syntax_error(const std::string &expected) const {
+    throw std::runtime_error{"syntax error, unexpected " + name(m_token.kind) + ", expecting " + expected +
+                             " on line " + std::to_string(m_token.line)};
+  }
+
+  void expect(token_kind kind) {
+    if (m_token.kind != kind) syntax_error(name(kind));
+    advance();
+  }
+
+  unsigned expect_vertex() {
+    if (m_token.kind != token_kind::unsigned_number) syntax_error(name(token_kind::unsigned_number));
+    const auto vertex = m_token.vertex;
+    advance();
+    return vertex;
+  }
+
+  double expect_value() {
+    if (m_token.kind != token_kind::unsigned_number && m_token.kind != token_kind::double_number)
+      syntax_error("unsigned or double");
+    const auto value = m_token.value;
+    advance();
+    return value;
+  }
+
+public:
+  explicit netlist_parser(std::string_view input) : m_cur{input.data()}, m_end{input.data() + input.size()} {}
+
+  // Passes every edge to sink in the order of the input, as soon as it's complete. What a syntax error says is expected
+  // follows the states of the LALR parser in parser.y.
+  template <typename F> void parse(F &&sink) {
+    advance();
+    auto first = expect_vertex();
+
+    while (true) {
+      network_edge edge{first};
+      expect(token_kind::line);
+      edge.second = expect_vertex();
+      expect(token_kind::comma);
+      edge.res = expect_value();
+      expect(token_kind::semicol);
+
+      // The edge may end here. A number after it is an EMF, unless it's an unsigned followed by "--", which starts the
+      // next edge.
+      if (m_token.kind == token_kind::eof) {
+        sink(edge);
+        return;
+      }
+
+      if (m_token.kind != token_kind::unsigned_number && m_token.kind != token_kind::double_number)
+        syntax_error("end of file or unsigned or double");
+
+      const auto number = m_token;
+      advance();
+
+      if (number.kind == token_kind::unsigned_number && m_token.kind == token_kind::line) {
+        sink(edge);
+        first = number.vertex;
+        continue;
+      }
+
+      expect(token_kind::voltage);
+      edge.emf = number.value;
+      sink(edge);
+
+      const auto semicol = (m_token.kind == token_kind::semicol);
+      if (semicol) advance();
+
+      if (m_token.kind == token_kind::eof) return;
+      if (m_token.kind != token_kind::unsigned_number)
+        syntax_error(semicol ? "end of file or unsigned" : "end of file or ; or unsigned");
+      first = expect_vertex();
+    }
+  }
+
+  std::vector<network_edge> parse() {
+    std::vector<network_edge> edges;
+    parse([&edges](const network_edge &edge) { edges.push_back(edge); });
+    return edges;
+  }
+};
+
+// Split the input into at most parts pieces that start at statement boundaries. Returns the offsets where the pieces
+// begin, the first one is always 0.
+inline std::vector<std::size_t> split_statements(std::string_view input, std::size_t parts) {
+  std::vector<std::size_t> starts = {0};
+  const auto               is_digit = [](char c) { return c >= '0' && c <= '9'; };
+  const auto               is_space = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; };
+
+  for (std::size_t i = 1; i < parts; ++i) {
+    auto line = input.find("--", std::max(starts.back() + 1, input.size() / parts * i));
+
+    for (; line != std::string_view::npos; line = input.find("--", line + 2)) {
+      auto digits_end = line;
+      while (digits_end > 0 && is_space(input[digits_end - 1])) {
+        --digits_end;
+      }
+
+      auto start = digits_end;
+      while (start > 0 && is_digit(input[start - 1])) {
+        --start;
+      }
+
+      // Without a number in front the input is malformed, the parser will say so. Keep looking.
+      if (start != digits_end && start > starts.back()) {
+        starts.push_back(start);
+        break;
+      }
+    }
+
+    if (line == std::string_view::npos) break;
+  }
+
+  return starts;
+}
+
+inline std::vector<network_edge> parse_netlist(std::string_view input) { return netlist_parser{input}.parse(); }
+
+template <typename F> void stream_netlist(std::string_view input, F &&sink) { netlist_parser{input}.parse(sink); }
+
+// Pieces are parsed into vectors of their own and handed to sink one after another, in order. Inputs smaller than
+// about a megabyte per thread aren't worth splitting.
+template <typename F> void stream_netlist(std::string_view input, throttle::concurrency::thread_pool &pool, F &&sink) {
+  constexpr std::size_t min_piece = 1 << 20;
+
+  const auto parts = std::min(4 * pool.size(), input.size() / min_piece);
+  if (parts < 2) return stream_netlist(input, sink);
+
+  const auto                             starts = split_statements(input, parts);
+  std::vector<std::vector<network_edge>> pieces(starts.size());
+  throttle::concurrency::task_graph      graph;
+
+  for (std::size_t i = 0; i < starts.size(); ++i) {
+    const auto finish = (i + 1 < starts.size() ? starts[i + 1] : input.size());
+    graph.add([&, i, piece = input.substr(starts[i], finish - starts[i])] { pieces[i] = parse_netlist(piece); });
+  }
+
+  try {
+    graph.run(pool);
+  } catch (std::runtime_error &) {
+    return stream_netlist(input, sink);
+  }
+
+  for (auto &piece : pieces) {
+    for (const auto &edge : piece) {
+      sink(edge);
+    }
+    std::vector<network_edge>{}.swap(piece);
+  }
+}
+
+inline std::vector<network_edge> parse_netlist(std::string_view input, throttle::concurrency::thread_pool &pool) {
+  std::vector<network_edge> edges;
+  stream_netlist(input, pool, [&edges](const network_edge &edge) { edges.push_back(edge); });
+  return edges;
+}
+
+} // namespace circuits
@@ -0,0 +1,113 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+/* NOTE[]: Output of the results straight to a file descriptor.
+ * Numbers are formatted with std::to_chars into one buffer that grows as needed and goes out with write() when flushed,
+ * so there's no locale, no sentry and no virtual call per value like with std::ostream. With chars_format::general
+ * to_chars is specified to give exactly what printf("%.*g") does, which is also what an ostream prints by default, so
+ * at precision 6 the output is byte for byte the same as with std::cout. Very large outputs are written out in pieces
+ * of flush_threshold bytes rather than held in memory whole.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+namespace circuits {
+
+class result_writer {
+  static constexpr std::size_t flush_threshold = 1 << 26;
+
+  int               m_fd, m_precision;
+  std::vector<char> m_buffer;
+  std::size_t       m_size = 0;
+
+  char *reserve(std::size_t count) {
+    if (m_buffer.size() - m_size < count) m_buffer.resize(std::max(2 * m_buffer.size(), m_size + count));
+    return m_buffer.data() + m_size;
+  }
+
+  void maybe_flush() {
+    if (m_size >= flush_threshold) flush();
+  }
+
+public:
+  // Precision is the number of significant digits, like std::setprecision.
+  explicit result_writer(int fd = STDOUT_FILENO, int precision = 6) : m_fd{fd}, m_precision{precision} {
+    m_buffer.resize(1 << 16);
+  }
+
+  result_writer(const result_writer &) = delete;
+  result_writer &operator=(const result_writer &) = delete;
+
+  // Whatever wasn't flushed explicitly goes out here, errors are lost then.
+  ~result_writer() {
+    try {
+      flush();
+    } catch (...) {
+    }
+  }
+
+  void flush() {
+    for (std::size_t written = 0; written < m_size;) {
+      const auto count = ::write(m_fd, m_buffer.data() + written, m_size - written);
+      if (count < 0) {
+        if (errno == EINTR) continue;
+        m_size = 0;
+        throw std::runtime_error{std::string{"Can't write the output: "} + std::strerror(errno)};
+      }
+      written += static_cast<std::size_t>(count);
+    }
+
+    m_size = 0;
+  }
+
+  result_writer &operator<<(std::string_view str) {
+    std::memcpy(reserve(str.size()), str.data(), str.size());
+    m_size += str.size();
+    maybe_flush();
+    return *this;
+  }
+
+  result_writer &operator<<(char c) {
+    *reserve(1) = c;
+    ++m_size;
+    return *this;
+  }
+
+  template <std::integral I> result_writer &operator<<(I value) {
+    constexpr std::size_t max_length = 24;
+    const auto            first = reserve(max_length);
+    m_size = std::to_chars(first, first + max_length, value).ptr - m_buffer.data();
+    return *this;
+  }
+
+  result_writer &operator<<(double value) {
+    // Sign, digits, point and an exponent of up to three digits.
+    const auto max_length = static_cast<std::size_t>(std::max(m_precision, 1)) + 16;
+    const auto first = reserve(max_length);
+    m_size = std::to_chars(first, first + max_length, value, std::chars_format::general, m_precision).ptr -
+             m_buffer.data();
+    return *this;
+  }
+};
+
+} // namespace circuits
@@ -0,0 +1,64 @@
+/*
+ * ----------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <tsimmerman.ss@phystech.edu>, <alex.rom23@mail.ru> wrote this file.  As long as you
+ * retain this notice you can do whatever you want with this stuff. If we meet
+ * some day, and you think this stuff is worth it, you can buy us a beer in
+ * return.
+ * ----------------------------------------------------------------------------
+ */
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "binary_netlist.hpp"
+#include "input_buffer.hpp"
+#include "netlist_parser.hpp"
+
+#include <boost/program_options.hpp>
+#include <boost/program_options/option.hpp>
+
+namespace po = boost::program_options;
+
+int main(int argc, char *argv[]) try {
+  std::string input_path, output_path;
+  unsigned    threads;
+
+  po::options_description desc("Available options");
+  desc.add_options()("help,h", "Print this help message")(
+      "input,i", po::value<std::string>(&input_path), "Text netlist, standard input if not given")(
+      "output,o", po::value<std::string>(&output_path), "Binary netlist to write")(
+      "labels,l", "Number the vertices densely and store their labels")(
+      "threads,j", po::value<unsigned>(&threads)->default_value(1), "Threads for parsing, 0 for all cores");
+  po::positional_options_description positional;
+  positional.add("input", 1);
+
+  po::variables_map vm;
+  po::store(po::command_line_parser(argc, argv).options(desc).positional(positional).run(), vm);
+  po::notify(vm);
+
+  if (vm.count("help") || !vm.count("output")) {
+    std::cout << desc << "\n";
+    return 1;
+  }
+
+  const auto input = (vm.count("input") ? circuits::input_buffer::from_file(input_path)
+                                         : circuits::input_buffer::from_stdin());
+
+  std::vector<circuits::network_edge> edges;
+  if (threads == 1) {
+    edges = circuits::parse_netlist(input.view());
+  } else {
+    throttle::concurrency::thread_pool pool{threads};
+    edges = circuits::parse_netlist(input.view(), pool);
+  }
+
+  std::ofstream os{output_path, std::ios::binary};
+  if (!os) throw std::runtime_error{"Can't open " + output_path};
+  circuits::binary_netlist::write(os, edges, vm.count("labels"));
+} catch (std::exception &e) {
+  std::cerr << "Encountered error: " << e.what() << "\n";
+  return 1;
+}
@@ -38,10 +38,15 @@
 
 #else
 
+#include "binary_netlist.hpp"
 #include "driver.hpp"
+#include "input_buffer.hpp"
+#include "netlist_parser.hpp"
+#include "result_writer.hpp"
 
 #endif
 
+#include "circuits/network_builder.hpp"
 #include "circuits/resistor_network.hpp"
 #include "linmath/linear_solver.hpp"
 
@@ -129,90 +134,108 @@ std::optional<std::vector<circuit_parser::graph::network_edge>> parse_circuit()
 
 namespace circuit_parser {
 
-std::vector<circuits::network_edge> parse_circuit() {
-  std::vector<circuits::network_edge> parse_result;
+using network_builder = throttle::circuits::network_builder<unsigned>;
 
-  std::string input;
-  std::noskipws(std::cin);
-  std::copy(std::istream_iterator<char>{std::cin}, std::istream_iterator<char>{}, std::back_inserter(input));
-
-  circuits::driver drv{};
+// Both parsers read the input where it lies, see input_buffer.hpp, and hand every edge to the builder as soon as it's
+// complete. Only the fast one can use threads.
+network_builder parse_circuit(std::string_view input, bool use_bison, unsigned threads) {
+  network_builder builder;
+  const auto      sink = [&builder](const circuits::network_edge &e) {
+    builder.insert(e.first, e.second, e.res, e.emf.value_or(0.0));
+  };
 
-  std::istringstream iss{input};
-  drv.switch_input_stream(&iss);
-  drv.parse();
+  if (!use_bison && threads == 1) {
+    circuits::stream_netlist(input, sink);
+  } else if (!use_bison) {
+    throttle::concurrency::thread_pool pool{threads};
+    circuits::stream_netlist(input, pool, sink);
+  } else {
+    circuits::driver drv{sink};
+
+    circuits::memory_streambuf buf{input};
+    std::istream               is{&buf};
+    drv.switch_input_stream(&is);
+    drv.parse();
+  }
 
-  return drv.m_parsed;
+  return builder;
 }
 
-} // namespace circuit_parser
-
-#endif
-
-int calculate_currents(auto circuit, bool verbose) {
-  using network_type = throttle::circuits::resistor_network<unsigned>;
-  network_type network;
-
-  std::unordered_map<unsigned, unsigned> input_vertex_to_mapped;
-  std::unordered_map<unsigned, unsigned> mapped_to_input_vertex;
-
-  unsigned count = 0;
-
-  const auto get_or_insert = [&count, &input_vertex_to_mapped, &mapped_to_input_vertex](unsigned index) {
-    if (input_vertex_to_mapped.contains(index)) {
-      return input_vertex_to_mapped.at(index);
+// A binary netlist with labels is numbered already, so nothing needs to be hashed.
+network_builder load_circuit(const circuits::binary_netlist &netlist) {
+  if (!netlist.labelled()) {
+    network_builder builder;
+    builder.reserve(netlist.records().size());
+    for (const auto &e : netlist.edges()) {
+      builder.insert(e.first, e.second, e.res, e.emf.value_or(0.0));
     }
+    return builder;
+  }
 
-    auto this_index = count++;
-    input_vertex_to_mapped[index] = this_index;
-    mapped_to_input_vertex[this_index] = index;
-
-    return this_index;
-  };
+  network_builder builder{{netlist.labels().begin(), netlist.labels().end()}};
+  builder.reserve(netlist.records().size());
+  for (const auto &e : netlist.records()) {
+    builder.insert_indexed(e.first, e.second, e.res, (e.flags & circuits::binary_edge::has_emf ? e.emf : 0.0));
+  }
+  return builder;
+}
 
-  std::vector<std::tuple<unsigned, unsigned, unsigned, unsigned>> currents_to_print;
+} // namespace circuit_parser
 
-  for (const auto &v : circuit) {
-    auto first_mapped = get_or_insert(v.first), second_mapped = get_or_insert(v.second);
-    auto temporary_first = count++, temporary_second = count++;
-    network.insert(first_mapped, temporary_first);
-    network.insert(temporary_first, temporary_second, v.res, v.emf.value_or(0.0));
-    network.insert(temporary_second, second_mapped);
-    currents_to_print.push_back(std::make_tuple(temporary_first, temporary_second, v.first, v.second));
-  }
+#endif
 
-  network_type::solution_currents currents;
+int calculate_currents(circuit_parser::network_builder &&circuit, bool verbose, unsigned precision,
+                       const throttle::circuits::solver_options &opts) {
+  // The builder isn't needed after this, so the labels move into the solution. Only the edges are left in it.
+  throttle::circuits::indexed_solution<unsigned> solution;
   try {
-    currents = network.solve().second;
+    solution = std::move(circuit).solve_indexed(opts);
   } catch (throttle::circuits::circuit_error &e) {
     std::cerr << "Bad circuit, bailing out. Here's the error message: " << e.what() << "\n";
     return EXIT_FAILURE;
   }
 
-  for (const auto &v : currents_to_print) {
-    auto [temp_1, temp_2, name_1, name_2] = v;
-    constexpr auto precision = 1e-6;
+  // Edge ids are given in the order of insertion, which is the order of the input.
+  circuits::result_writer out{STDOUT_FILENO, static_cast<int>(precision)};
+  for (std::size_t i = 0; i < circuit.edges(); ++i) {
+    constexpr auto threshold = 1e-6;
 
-    auto current = currents.at(temp_1).at(temp_2);
-    auto rounded_current = (std::abs(current) > precision ? current : 0.0);
+    const auto &v = circuit.edge(i);
+    auto        current = solution.current(i);
+    auto        rounded_current = (std::abs(current) > threshold ? current : 0.0);
 
     if (verbose) {
-      std::cout << name_1 << " -- " << name_2 << ": " << rounded_current << " A\n";
+      out << solution.label(v.first) << " -- " << solution.label(v.second) << ": " << rounded_current << " A\n";
     } else {
-      std::cout << rounded_current << "\n";
+      out << rounded_current << "\n";
     }
   }
 
+  out.flush();
+
   return EXIT_SUCCESS;
 }
 
 int main(int argc, char *argv[]) try {
   bool non_verbose = false;
 
+  std::string solver_name, parser_name, input_path;
+  unsigned    threads, precision;
+
   po::options_description desc("Available options");
-  desc.add_options()("help,h", "Print this help message")("nonverbose,n", "Non-verbose output");
+  desc.add_options()("help,h", "Print this help message")("nonverbose,n", "Non-verbose output")(
+      "solver,s", po::value<std::string>(&solver_name)->default_value("sparse"),
+      "Linear solver: sparse, dense, cg or amg")(
+      "threads,j", po::value<unsigned>(&threads)->default_value(1),
+      "Threads for parsing, independent components or the dense solver, 0 for all cores")(
+      "parser", po::value<std::string>(&parser_name)->default_value("fast"), "Netlist parser: fast or bison")(
+      "precision", po::value<unsigned>(&precision)->default_value(6), "Significant digits of the currents")(
+      "input,i", po::value<std::string>(&input_path), "Netlist file, text or binary, standard input if not given");
+  po::positional_options_description positional;
+  positional.add("input", 1);
+
   po::variables_map vm;
-  po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+  po::store(po::command_line_parser(argc, argv).options(desc).positional(positional).run(), vm);
   po::notify(vm);
 
   if (vm.count("help")) {
@@ -220,11 +243,33 @@ int main(int argc, char *argv[]) try {
     return 1;
   }
 
+  throttle::circuits::solver_options opts;
+  opts.threads = threads;
+  if (solver_name == "sparse") opts.method = throttle::circuits::solver_method::sparse;
+  else if (solver_name == "dense") opts.method = throttle::circuits::solver_method::dense;
+  else if (solver_name == "cg") opts.method = throttle::circuits::solver_method::conjugate_gradient;
+  else if (solver_name == "amg") {
+    opts.method = throttle::circuits::solver_method::conjugate_gradient;
+    opts.cg.preconditioner = throttle::linmath::preconditioner_kind::algebraic_multigrid;
+  } else throw std::invalid_argument("Unknown solver: " + solver_name);
+
+  if (parser_name != "fast" && parser_name != "bison") throw std::invalid_argument("Unknown parser: " + parser_name);
+
   non_verbose = vm.count("nonverbose");
-  auto parsed = circuit_parser::parse_circuit();
-  return calculate_currents(parsed, !non_verbose);
+  const auto input = (vm.count("input") ? circuits::input_buffer::from_file(input_path)
+                                         : circuits::input_buffer::from_stdin());
+
+  // Binary netlists from netconv need no parsing, see binary_netlist.hpp.
+  if (circuits::binary_netlist::is_binary(input.view()))
+    return calculate_currents(circuit_parser::load_circuit(circuits::binary_netlist{input.view()}), !non_verbose,
+                              precision, opts);
+
+  auto circuit = circuit_parser::parse_circuit(input.view(), parser_name == "bison", threads);
+  return calculate_currents(std::move(circuit), !non_verbose, precision, opts);
 } catch (std::exception &e) {
   std::cerr << "Encountered error: " << e.what() << "\n";
+  return EXIT_FAILURE;
 } catch (...) {
   std::cerr << "Unknown error\n";
+  return EXIT_FAILURE;
 }
\ No newline at end of file
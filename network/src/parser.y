@@ -77,7 +77,7 @@ static circuits::parser::symbol_type yylex(circuits::scanner &p_scanner, circuit
 %type <double> unsigned_or_double
 
 %type <circuits::network_edge> trailing_edge last_edge
-%type <std::vector<circuits::network_edge>> network
+%type <std::optional<circuits::network_edge>> network
 
 %start all
 
@@ -85,11 +85,16 @@ static circuits::parser::symbol_type yylex(circuits::scanner &p_scanner, circuit
 
 %%
 
-all: network  { driver.m_parsed = std::move($1); }
+/* An edge still pending at the end means the input stopped after "N --", the same error as from netlist_parser.hpp */
 
-network:  network trailing_edge     { $$ = std::move($1); auto first = $2.first; $2.first = $$.back().first; $$.back() = $2; $$.emplace_back(first); }
-          | network last_edge       { $$ = std::move($1); $2.first = $$.back().first; $$.back() = $2; }
-          | UNSIGNED LINE           { $$.emplace_back($1, 0, 0, std::nullopt); }
+all: network                        { if ($1) throw syntax_error{"syntax error, unexpected end of file, expecting unsigned"}; }
+
+/* network is the edge that has been started but is not complete yet, or none after the last one. Finished edges go to
+   the driver right away */
+
+network:  network trailing_edge     { auto first = $2.first; $2.first = $1->first; driver.emit($2); $$ = network_edge{first}; }
+          | network last_edge       { $2.first = $1->first; driver.emit($2); $$ = std::nullopt; }
+          | UNSIGNED LINE           { $$ = network_edge{$1}; }
 
 trailing_edge:  UNSIGNED COMMA unsigned_or_double SEMICOL unsigned_or_double VOLTAGE UNSIGNED LINE              { $$ = {$7, $1, $3, $5}; }
                 | UNSIGNED COMMA unsigned_or_double SEMICOL unsigned_or_double VOLTAGE SEMICOL UNSIGNED LINE    { $$ = {$8, $1, $3, $5}; }
@@ -104,7 +109,7 @@ unsigned_or_double: UNSIGNED  { $$ = $1; }
 
 %%
 
-// Bison expects us to provide implementation - otherwise linker complains
+// Bison expects us to provide implementation - otherwise linker complains. Errors from the scanner end up here too.
 void circuits::parser::error(const std::string &message) {
-  throw std::runtime_error{message};
+  throw std::runtime_error{message + " on line " + std::to_string(scanner.lineno())};
 }
\ No newline at end of file
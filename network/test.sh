@@ -21,11 +21,129 @@ for file in *.dat; do
     echo "${red}Failed${reset}"
     passed=false
   fi
+
+  echo -n "Testing $green$file$reset with bison ..."
+  rm -f ans.tmp
+
+  if $1 --parser bison --nonverbose < $file > ans.tmp && $3 $filename ans.tmp; then
+    echo "${green}Passed${reset}"
+  else
+    echo "${red}Failed${reset}"
+    passed=false
+  fi
+
+  # The same netlist converted to the binary format, if netconv is given
+  if [ -n "$4" ]; then
+    echo -n "Testing $green$file$reset in binary ..."
+    rm -f ans.tmp bin.tmp
+
+    if $4 $file -o bin.tmp --labels && $1 --nonverbose bin.tmp > ans.tmp && $3 $filename ans.tmp; then
+      echo "${green}Passed${reset}"
+    else
+      echo "${red}Failed${reset}"
+      passed=false
+    fi
+  fi
 done
 
+# Netlists the hand-written scanner reads differently from flex. Arguments are the name of the case, the netlist, the
+# parser and the expected currents, or "error" if the netlist must be rejected.
+network=$1
+compare=$3
+
+check_parser() {
+  echo -n "Testing $green$1$reset with the $3 parser ..."
+  rm -f ans.tmp exp.tmp
+
+  if [ "$4" = "error" ]; then
+    ! printf '%s' "$2" | $network --parser $3 --nonverbose 2> ans.tmp && grep -q "syntax error" ans.tmp
+  else
+    printf '%b' "$4" > exp.tmp
+    printf '%s' "$2" | $network --parser $3 --nonverbose > ans.tmp && $compare exp.tmp ans.tmp
+  fi
+
+  if [ $? -eq 0 ]; then
+    echo "${green}Passed${reset}"
+  else
+    echo "${red}Failed${reset}"
+    passed=false
+  fi
+}
+
+# flex splits 1.05 in two, since a fraction can't start with 0 there
+check_parser "1.05" "1 -- 2, 1.05; 2 -- 1, 1; 3 V" fast "1.46341\n1.46341\n"
+check_parser "lone vertex" "1 -- 2, 1; 2 -- 1, 1; 7 --" fast error
+check_parser "lone vertex" "1 -- 2, 1; 2 -- 1, 1; 7 --" bison error
+check_parser "lone vertex only" "7 --" fast error
+check_parser "lone vertex only" "7 --" bison error
+check_parser "plus sign" "1 -- 2, +2; 2 -- 1, 2; +4 V" fast "1\n1\n"
+check_parser "plus sign" "1 -- 2, +2; 2 -- 1, 2; +4 V" bison "1\n1\n"
+
+# Both parsers must reject these with the same message and line number.
+check_errors() {
+  echo -n "Testing the error for $green$1$reset ..."
+
+  if ! printf "$2" | $network --parser fast 2> ans.tmp > /dev/null &&
+     ! printf "$2" | $network --parser bison 2> exp.tmp > /dev/null && grep -q "on line" ans.tmp &&
+     cmp -s ans.tmp exp.tmp; then
+    echo "${green}Passed${reset}"
+  else
+    echo "${red}Failed${reset}"
+    passed=false
+  fi
+}
+
+check_errors "an unexpected symbol" "1 -- 2, 3;\n\n x"
+check_errors "a missing comma" "1 --\n 2 2"
+check_errors "a missing semicolon" "1 -- 2, 3\n\n"
+check_errors "an EMF without V" "1 -- 2,\n 3;\n\n 4 5"
+check_errors "a number out of range" "1 -- 2, 1;\n 99999999999 -- 1, 2;"
+check_errors "a truncated netlist" "1 -- 2, 1;\n 2 -- 1, 1;\n 7 --\n"
+
+# A netlist of several megabytes is parsed in pieces on a thread pool, which must give the same edges and the same
+# errors as parsing it serially. The argument is the edge to break, -1 for none.
+big_netlist() {
+  awk -v bad="$1" 'BEGIN {
+    split(" |\t|\n|\r\n|  \n\t ", sep, "|")
+    for (i = 0; i < 250000; ++i) {
+      s = sep[i % 5 + 1]
+      if (i == bad) { printf "%d -- %d, ;%s", i % 1000, i % 997, s; continue }
+      printf "%d%s--%s%d,%s%d.%d;%s", i % 1000, s, s, i % 997, s, i % 10 + 1, i % 100, s
+      if (i % 3 == 1) printf "%d V%s", i % 9, s
+      if (i % 3 == 2) printf "-%d.5 V;%s", i % 4, s
+    }
+  }'
+}
+
+if [ -n "$4" ]; then
+  echo -n "Testing ${green}a large netlist${reset} with 1 and 4 threads ..."
+  big_netlist -1 > big.tmp
+  rm -f bin.tmp bin4.tmp
+
+  if $4 big.tmp -o bin.tmp -j 1 && $4 big.tmp -o bin4.tmp -j 4 && cmp -s bin.tmp bin4.tmp; then
+    echo "${green}Passed${reset}"
+  else
+    echo "${red}Failed${reset}"
+    passed=false
+  fi
+
+  echo -n "Testing ${green}a syntax error in a large netlist${reset} with 1 and 4 threads ..."
+  big_netlist 200000 > big.tmp
+
+  if ! $4 big.tmp -o bin.tmp -j 1 2> err.tmp && ! $4 big.tmp -o bin4.tmp -j 4 2> err4.tmp &&
+     grep -q "syntax error" err.tmp && cmp -s err.tmp err4.tmp; then
+    echo "${green}Passed${reset}"
+  else
+    echo "${red}Failed${reset}"
+    passed=false
+  fi
+fi
+
+rm -f ans.tmp bin.tmp exp.tmp big.tmp bin4.tmp err.tmp err4.tmp
+
 if ${passed}
 then
   exit 0
 else
   exit 666
-fi
\ No newline at end of file
+fi